@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct OverlapMatch {
+  double score = 0.0;
+  uint32_t first = 0;
+  uint32_t second = 0;
+  int32_t offset = 0;
+  uint32_t overlap = 0;
+  uint32_t coincidences = 0;
+};
+
+class Banburismus {
+public:
+  static constexpr double PLAINTEXT_COINCIDENCE = 0.0667;
+  static constexpr double RANDOM_COINCIDENCE = 1.0 / 26.0;
+  static constexpr unsigned int MESSAGES_PER_TILE = 32;
+
+  Banburismus(const std::vector<std::string> &messages,
+              unsigned int minOverlap);
+
+  std::vector<OverlapMatch> score(unsigned int limit,
+                                  unsigned int threads = 0) const;
+  uint64_t getComparisonCount() const;
+
+  static uint32_t countCoincidences(const char *first, const char *second,
+                                    size_t length);
+  static double getWeight(uint32_t overlap, uint32_t coincidences);
+
+private:
+  void scorePair(uint32_t first, uint32_t second,
+                 std::vector<OverlapMatch> &best, unsigned int limit) const;
+
+  std::vector<std::string> messages_;
+  unsigned int minOverlap_ = 1;
+};
+
+int printBanburismus(const std::string &path, unsigned int minOverlap,
+                     unsigned int limit, unsigned int threads);
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ncurses.h>
+#include <string>
+#include <vector>
+
+class Canvas {
+public:
+  virtual ~Canvas() = default;
+
+  static constexpr unsigned int NORMAL = 0;
+  static constexpr unsigned int BOLD = 1 << 0;
+  static constexpr unsigned int DIM = 1 << 1;
+  static constexpr unsigned int SELECTED = 1 << 2;
+  static constexpr unsigned int ACTIVE = 1 << 3;
+
+  virtual unsigned int getHeight() const = 0;
+  virtual unsigned int getWidth() const = 0;
+  virtual void write(unsigned int y, unsigned int x, const char *text,
+                     size_t length) = 0;
+  virtual void erase() = 0;
+  virtual void clear() = 0;
+  virtual void drawBox() = 0;
+  virtual void refresh() = 0;
+
+  void print(unsigned int y, unsigned int x, const char *format, ...)
+      __attribute__((format(printf, 4, 5)));
+  void setStyle(unsigned int style);
+  void addStyle(unsigned int style);
+  void removeStyle(unsigned int style);
+  unsigned int getStyle() const;
+
+protected:
+  virtual void applyStyle() {}
+
+  unsigned int style_ = NORMAL;
+};
+
+class NcursesCanvas : public Canvas {
+public:
+  explicit NcursesCanvas(WINDOW *window);
+
+  unsigned int getHeight() const override;
+  unsigned int getWidth() const override;
+  void write(unsigned int y, unsigned int x, const char *text,
+             size_t length) override;
+  void erase() override;
+  void clear() override;
+  void drawBox() override;
+  void refresh() override;
+
+private:
+  void applyStyle() override;
+
+  WINDOW *window_ = nullptr;
+};
+
+struct Cell {
+  char symbol = ' ';
+  uint8_t style = Canvas::NORMAL;
+
+  bool operator==(const Cell &other) const = default;
+};
+
+class MemoryCanvas : public Canvas {
+public:
+  MemoryCanvas(unsigned int height, unsigned int width);
+
+  unsigned int getHeight() const override;
+  unsigned int getWidth() const override;
+  void write(unsigned int y, unsigned int x, const char *text,
+             size_t length) override;
+  void erase() override;
+  void clear() override;
+  void drawBox() override;
+  void refresh() override;
+
+  const Cell &getCell(unsigned int y, unsigned int x) const;
+  size_t countChangedCells(const MemoryCanvas &previous) const;
+  unsigned long long getRefreshCount() const;
+  std::string toString() const;
+
+private:
+  unsigned int height_ = 0;
+  unsigned int width_ = 0;
+  std::vector<Cell> cells_;
+  unsigned long long refreshCount_ = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include "../include/EnigmaMachine.hpp"
+#include "../include/Permutation.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct KeyCursor {
+  uint16_t state = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<KeyCursor>);
+
+class CompiledKey {
+public:
+  static constexpr unsigned int POSITIONS = 26 * 26 * 26;
+
+  explicit CompiledKey(const EnigmaMachine &machine);
+  static std::shared_ptr<const CompiledKey>
+  compile(const EnigmaMachine &machine);
+
+  static KeyCursor getCursor(
+      const std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> &positions);
+  static std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>
+  getPositions(KeyCursor cursor);
+  const Permutation &getPermutation(KeyCursor cursor) const {
+    return permutations_[cursor.state];
+  }
+  KeyCursor getNext(KeyCursor cursor) const { return {next_[cursor.state]}; }
+
+  char encrypt(KeyCursor &cursor, char letter) const;
+  void encryptText(KeyCursor &cursor, char *text, size_t length) const;
+  void encryptText(KeyCursor &cursor, std::string &text) const;
+  void step(KeyCursor &cursor, int direction = -1) const;
+
+  static size_t getTableBytes();
+
+private:
+  std::vector<Permutation> permutations_;
+  std::vector<uint16_t> next_;
+  std::vector<uint16_t> previous_;
+};
+
+int runCursorBenchmark(unsigned int threads, unsigned int length);
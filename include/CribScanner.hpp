@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CribScanner {
+public:
+  static constexpr unsigned int MAX_CRIB_LENGTH = 64;
+
+  explicit CribScanner(const std::string &crib);
+
+  bool isValid() const;
+  size_t getCribLength() const;
+
+  std::vector<uint64_t> scan(const char *text, size_t length,
+                             unsigned int threads = 0) const;
+  static uint64_t countPositions(const std::vector<uint64_t> &positions);
+
+private:
+  void scanRange(const char *text, size_t length, size_t first, size_t last,
+                 uint64_t *positions) const;
+  void scanRangeBitParallel(const char *text, size_t first, size_t last,
+                            uint64_t *positions) const;
+
+  std::string crib_ = "";
+  std::array<uint64_t, 256> letterMasks_ = {};
+};
+
+int printCribPositions(const std::string &path, const std::string &crib,
+                       bool countOnly);
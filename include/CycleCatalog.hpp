@@ -0,0 +1,48 @@
+#pragma once
+#include "../include/EnigmaMachine.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct CycleSetting {
+  std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> order = {};
+  std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> positions = {};
+};
+
+class CycleCatalog {
+public:
+  CycleCatalog() = default;
+  ~CycleCatalog();
+  CycleCatalog(const CycleCatalog &) = delete;
+  CycleCatalog &operator=(const CycleCatalog &) = delete;
+
+  static constexpr unsigned int POSITIONS = 26 * 26 * 26;
+  static constexpr uint32_t INVALID_SIGNATURE = 0xFFFFFFFF;
+
+  static int build(const EnigmaMachine &machine, const std::string &path,
+                   unsigned int threads = 0);
+  static uint32_t parseSignature(const std::array<std::string, 3> &cycles);
+  static std::string describeSignature(uint32_t signature);
+
+  int open(const std::string &path);
+  void close();
+
+  size_t query(uint32_t signature, const uint32_t *&settings) const;
+  CycleSetting decodeSetting(uint32_t setting) const;
+  size_t getSignatureCount() const;
+  size_t getSettingCount() const;
+  unsigned int getRotorCount() const;
+
+private:
+  const uint32_t *words_ = nullptr;
+  size_t length_ = 0;
+  const uint32_t *orders_ = nullptr;
+  const uint32_t *index_ = nullptr;
+  const uint32_t *entries_ = nullptr;
+};
+
+int buildCycleCatalog(const std::string &path, unsigned int threads);
+int queryCycleCatalog(const std::string &path,
+                      const std::array<std::string, 3> &cycles,
+                      unsigned int limit);
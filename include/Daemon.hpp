@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+constexpr const char *DEFAULT_SOCKET_PATH = "/tmp/enigma_machine.sock";
+
+int runDaemon(const std::string &socketPath);
+int runClient(const std::string &socketPath, unsigned int connections,
+              unsigned int requests, unsigned int messageLength,
+              unsigned int pipelineDepth);
@@ -1,33 +1,46 @@
 #pragma once
+#include "../include/Canvas.hpp"
 #include "../include/EnigmaMachine.hpp"
+#include "../include/KeyCache.hpp"
+#include "../include/TextStatistics.hpp"
 #include <ncurses.h>
-#include <utility>
+#include <string>
+
+constexpr unsigned int OUTPUT_Y_PADDING = 2, OUTPUT_X_PADDING = 4;
 
 struct Subwindows {
-  const unsigned int MAX_SUBWINDOWS = 4;
-  WINDOW *rotors, *output, *keyboard, *plugBoard = nullptr;
+  const unsigned int MAX_SUBWINDOWS = 5;
+  const unsigned int MAX_ROWS = 4;
+  WINDOW *rotors, *output, *statistics, *keyboard, *plugBoard = nullptr;
+};
+
+struct SubwindowCanvases {
+  Canvas *rotors = nullptr, *output = nullptr, *statistics = nullptr,
+         *keyboard = nullptr, *plugBoard = nullptr;
 };
 
 int setupWindows(WINDOW *windowMain, Subwindows &subwindows);
-void refreshWindows(WINDOW *windowMain, Subwindows &subwindows);
-void clearWindows(WINDOW *windowMain, Subwindows &subwindows);
+void refreshWindows(Canvas &windowMain, SubwindowCanvases &subwindows);
+void clearWindows(Canvas &windowMain, SubwindowCanvases &subwindows);
+
+void drawSubwindowBoxes(SubwindowCanvases &subwindows);
+void highlightSubwindow(Canvas &subwindow);
 
-void drawSubwindowBoxes(Subwindows &subwindows);
-void highlightSubwindow(WINDOW *subwindow);
+enum EscapeAction { ESCAPE_RESUME, ESCAPE_RESET, ESCAPE_EXIT };
 
-bool escapeMenu(WINDOW *windowOutput, EnigmaMachine &enigmaMachine,
-                const int ESC_KEY, const int ENTER_KEY);
-void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
+EscapeAction escapeMenu(Canvas &windowOutput, EnigmaMachine &enigmaMachine,
+                        const int ESC_KEY, const int ENTER_KEY);
+void rotorConfigMenu(Canvas &windowRotors, EnigmaMachine &enigmaMachine,
                      const int ESC_KEY, const int ENTER_KEY);
-void plugBoardConfigMenu(WINDOW *windowPlugBoard, EnigmaMachine &enigmaMachine,
+void plugBoardConfigMenu(Canvas &windowPlugBoard, EnigmaMachine &enigmaMachine,
                          const int ESC_KEY);
 
-void drawKeyboard(WINDOW *windowKeyboard, const int keyPress);
-void removeKeyPress(
-    WINDOW *windowKeyboard,
-    const std::pair<char, std::pair<unsigned int, unsigned int>> activeKey);
+void drawKeyboard(Canvas &windowKeyboard, const int keyPress);
 
-void drawRotors(WINDOW *windowRotors, const EnigmaMachine &enigmaMachine);
-void drawPlugBoard(WINDOW *windowPlugBoard, const EnigmaMachine &enigmaMachine);
-bool drawOutput(WINDOW *windowOutput, const int inputKey,
-                const bool reset = false);
+void drawRotors(Canvas &windowRotors, const EnigmaMachine &enigmaMachine);
+void drawPlugBoard(Canvas &windowPlugBoard, const EnigmaMachine &enigmaMachine);
+unsigned int getOutputCapacity(const Canvas &windowOutput);
+void drawOutput(Canvas &windowOutput, const std::string &text);
+void drawStatistics(Canvas &windowStatistics,
+                    const TextStatistics &statistics,
+                    const KeyCacheStats &keyCache);
@@ -0,0 +1,67 @@
+#pragma once
+#include "../include/CompiledKey.hpp"
+#include "../include/EnigmaMachine.hpp"
+#include "../include/KeyCache.hpp"
+#include "../include/SpscQueue.hpp"
+#include "../include/TextStatistics.hpp"
+#include "../include/TripleBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct EngineSnapshot {
+  explicit EngineSnapshot(const EnigmaMachine &initialMachine)
+      : machine(initialMachine) {}
+
+  EnigmaMachine machine;
+  std::string outputText = "";
+  TextStatistics statistics;
+  KeyCacheStats keyCache;
+  char lastKey = '\0';
+  unsigned long long keyPresses = 0;
+};
+
+class Engine {
+public:
+  explicit Engine(const EnigmaMachine &machine);
+  ~Engine();
+
+  static constexpr char BACKSPACE = '\b';
+
+  void start();
+  void stop();
+
+  bool submit(char key);
+  void flush();
+  void setOutputCapacity(size_t capacity);
+
+  void pause();
+  void resume();
+  EnigmaMachine &getMachine();
+  void resetOutput();
+
+  bool updateSnapshot();
+  const EngineSnapshot &getSnapshot() const;
+
+private:
+  static constexpr size_t QUEUE_CAPACITY_ = 1 << 16;
+
+  void run();
+  bool drain();
+  void process(char key);
+  void publish();
+
+  EngineSnapshot state_;
+  std::shared_ptr<const CompiledKey> key_;
+  SpscQueue<char, QUEUE_CAPACITY_> keys_;
+  TripleBuffer<EngineSnapshot> snapshots_;
+
+  std::atomic<size_t> outputCapacity_ = 0;
+  std::atomic<unsigned long long> submitted_ = 0;
+  std::atomic<bool> stopRequested_ = false;
+  std::atomic<bool> pauseRequested_ = false;
+  std::atomic<bool> parked_ = false;
+  std::thread worker_;
+};
@@ -1,48 +1,66 @@
 #pragma once
+#include "../include/Permutation.hpp"
 #include <array>
+#include <cctype>
+#include <cstdint>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <type_traits>
 #include <vector>
 
 class EnigmaMachine;
 EnigmaMachine setupEnigmaMachine();
 
+struct RotorWiring {
+  static constexpr unsigned int MAX_SYMBOLS = 26;
+
+  std::string modelName = "";
+  std::array<char, MAX_SYMBOLS> symbols = {};
+  std::array<unsigned char, MAX_SYMBOLS> inverse = {};
+  char notch = '\0';
+  int notchPosition = -1;
+  Permutation forward;
+  Permutation backward;
+
+  static uint16_t add(const std::string &modelName, const std::string &symbols,
+                      char notch);
+  static const RotorWiring &get(uint16_t id);
+};
+
 class Rotor {
 public:
+  Rotor() = default;
   Rotor(const std::string &modelName, const std::string &symbols, char notch);
-  virtual ~Rotor() = default;
-  virtual void spin(int direction = -1);
-  void transfer(char &key, int direction = 1);
+  void spin(int direction = -1);
+  void transfer(char &key, int direction = 1) const;
   const std::string &getModelName() const;
-  virtual char getNotch(const int offset = 0) const;
-  virtual char getActiveSymbol(const int offset = 0) const;
+  char getNotch(const int offset = 0) const;
+  char getActiveSymbol(const int offset = 0) const;
+  unsigned int getPosition() const;
+  void setPosition(unsigned int position);
+  Permutation getPermutation(int direction = 1) const;
+  uint16_t getWiringId() const;
 
-  bool operator==(const Rotor &other) const {
-    return modelName_ == other.modelName_;
-  }
-  bool operator!=(const Rotor &other) const {
-    return modelName_ != other.modelName_;
-  }
+  bool operator==(const Rotor &other) const { return id_ == other.id_; }
+  bool operator!=(const Rotor &other) const { return id_ != other.id_; }
 
 protected:
-  static constexpr unsigned int MAX_SYMBOLS_ = 26;
-  std::string modelName_ = "";
-  std::array<char, MAX_SYMBOLS_> symbols_ = {};
-  std::unordered_map<char, int> alphabet_;
-  unsigned int position_ = 0;
-
-private:
-  char notch_ = '\0';
-  char activeSymbol_ = '\0';
+  static constexpr unsigned int MAX_SYMBOLS_ = RotorWiring::MAX_SYMBOLS;
+  uint16_t id_ = 0;
+  uint8_t position_ = 0;
 };
 
 class Reflector : public Rotor {
 public:
+  Reflector() = default;
   Reflector(const std::string &modelName, const std::string &symbols);
 
 private:
 };
 
+static_assert(std::is_trivially_copyable_v<Rotor>);
+static_assert(std::is_trivially_copyable_v<Reflector>);
+
 struct Cable {
   Cable(char input, char output)
       : input_(toupper(input)), output_(toupper(output)) {}
@@ -54,6 +72,8 @@ struct Cable {
   void transfer(char &key);
 };
 
+static_assert(std::is_trivially_copyable_v<Cable>);
+
 class EnigmaMachine {
 public:
   EnigmaMachine(std::vector<Rotor> &rotors, std::vector<Reflector> &reflectors,
@@ -63,22 +83,37 @@ public:
   static constexpr unsigned int MAX_CABLES_ = 10;
 
   void encrypt(char &key);
+  void encryptText(std::string &text);
+  void encryptText(char *text, size_t length);
   void spinRotors(int direction = -1);
   void setRotor(const Rotor &inputRotor, const Rotor &originalRotor,
                 unsigned int index);
   void setSymbol(const Rotor &rotor, int direction);
   void setPlug(const int index, const bool input, const int direction);
-
-  const std::vector<Rotor> &getAvaliableRotors() const;
-  const std::vector<Rotor> &getActiveRotors() const;
-  const std::vector<Cable> &getActivePlugs() const;
+  void setCable(unsigned int index, char input, char output);
+  void setRotorOrder(const std::array<unsigned int, MAX_ROTORS_> &order);
+  void setRotorPositions(
+      const std::array<unsigned int, MAX_ROTORS_> &positions);
+  int setKey(const std::string &key);
+
+  std::array<unsigned int, MAX_ROTORS_> getRotorPositions() const;
+  std::string describeKey() const;
+  Permutation getPlugBoardPermutation() const;
+  const Reflector &getReflector() const;
+  Permutation getPermutation() const;
+  Permutation getRotorPermutation(unsigned int first) const;
+
+  std::span<const Rotor> getAvaliableRotors() const;
+  std::vector<std::array<unsigned int, MAX_ROTORS_>> getRotorOrders() const;
+  std::span<const Rotor, MAX_ROTORS_> getActiveRotors() const;
+  std::span<const Cable> getActivePlugs() const;
 
 private:
   static constexpr unsigned int MAX_REFLECTORS_ = 1;
 
   std::vector<Rotor> avaliableRotors_ = {};
   std::vector<Reflector> avaliableReflectors_ = {};
-  std::vector<Rotor> activeRotors_;
+  std::array<Rotor, MAX_ROTORS_> activeRotors_ = {};
 
   Reflector currentReflector_ = avaliableReflectors_[0];
 
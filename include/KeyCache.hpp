@@ -0,0 +1,63 @@
+#pragma once
+#include "../include/CompiledKey.hpp"
+#include "../include/EnigmaMachine.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct KeyConfiguration {
+  std::array<uint16_t, EnigmaMachine::MAX_ROTORS_> rotors = {};
+  uint16_t reflector = 0;
+  std::array<uint8_t, Permutation::SIZE> plugBoard = {};
+
+  static KeyConfiguration fromMachine(const EnigmaMachine &machine);
+  uint64_t hash() const;
+  bool operator==(const KeyConfiguration &other) const = default;
+};
+
+struct KeyCacheStats {
+  unsigned long long hits = 0;
+  unsigned long long misses = 0;
+  unsigned long long evictions = 0;
+  size_t entries = 0;
+  size_t capacity = 0;
+  size_t bytes = 0;
+};
+
+class KeyCache {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 16;
+
+  explicit KeyCache(size_t capacity = DEFAULT_CAPACITY);
+  static KeyCache &getShared();
+
+  std::shared_ptr<const CompiledKey> get(const EnigmaMachine &machine);
+  KeyCacheStats getStats() const;
+  void clear();
+
+private:
+  struct ConfigurationHash {
+    size_t operator()(const KeyConfiguration &configuration) const {
+      return configuration.hash();
+    }
+  };
+
+  using Entry =
+      std::pair<KeyConfiguration,
+                std::shared_future<std::shared_ptr<const CompiledKey>>>;
+
+  void forget(const KeyConfiguration &configuration);
+
+  mutable std::mutex mutex_;
+  size_t capacity_ = DEFAULT_CAPACITY;
+  std::list<Entry> recent_;
+  std::unordered_map<KeyConfiguration, std::list<Entry>::iterator,
+                     ConfigurationHash>
+      entries_;
+  KeyCacheStats stats_;
+};
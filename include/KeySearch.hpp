@@ -0,0 +1,64 @@
+#pragma once
+#include "../include/CompiledKey.hpp"
+#include "../include/EnigmaMachine.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SearchResult {
+  uint64_t score = 0;
+  uint32_t key = 0;
+};
+
+struct SearchShard {
+  uint32_t firstKey = 0;
+  uint32_t nextKey = 0;
+  uint32_t lastKey = 0;
+  bool done = false;
+  std::vector<SearchResult> results;
+};
+
+class KeySearch {
+public:
+  static constexpr unsigned int POSITIONS = 26 * 26 * 26;
+  static constexpr unsigned int CHECKPOINT_SECONDS = 1;
+
+  static int create(const std::string &directory,
+                    const std::string &ciphertext, unsigned int shards,
+                    unsigned int keep);
+
+  int open(const std::string &directory);
+  int work(unsigned int firstShard);
+
+  unsigned int getShardCount() const;
+  uint32_t getKeyCount() const;
+  int loadShard(unsigned int shard, SearchShard &state) const;
+  std::vector<SearchResult> merge(unsigned int &shardsDone,
+                                  uint64_t &keysSearched) const;
+  double getIndexOfCoincidence(uint64_t score) const;
+  std::string describeKey(uint32_t key) const;
+
+private:
+  std::string getShardPath(unsigned int shard, const char *extension) const;
+  int saveShard(unsigned int shard, const SearchShard &state) const;
+  int runShard(unsigned int shard, SearchShard &state);
+  void compileOrder(unsigned int order);
+
+  std::string directory_ = "";
+  EnigmaMachine machine_ = setupEnigmaMachine();
+  std::vector<std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>> orders_;
+  unsigned int shardCount_ = 0;
+  unsigned int keep_ = 0;
+  std::vector<uint8_t> letters_;
+
+  int compiledOrder_ = -1;
+  std::shared_ptr<const CompiledKey> orderKey_;
+};
+
+int createKeySearch(const std::string &directory,
+                    const std::string &ciphertext, unsigned int shards,
+                    unsigned int keep);
+int runKeySearch(const std::string &directory, unsigned int processes);
+int printKeySearch(const std::string &directory, unsigned int limit);
@@ -0,0 +1,29 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class LatencyHistogram {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void record(Clock::duration latency);
+  void merge(const LatencyHistogram &other);
+  void clear();
+
+  uint64_t getCount() const;
+  uint64_t getMaxMicroseconds() const;
+  double getMeanMicroseconds() const;
+  uint64_t getPercentileMicroseconds(double percentile) const;
+  std::string summary() const;
+
+private:
+  static constexpr unsigned int FINE_BUCKETS_ = 1000;
+  static constexpr unsigned int COARSE_BUCKETS_ = 1000;
+
+  std::array<uint64_t, FINE_BUCKETS_ + COARSE_BUCKETS_ + 1> buckets_ = {};
+  uint64_t count_ = 0;
+  uint64_t totalMicroseconds_ = 0;
+  uint64_t maxMicroseconds_ = 0;
+};
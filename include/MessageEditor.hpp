@@ -0,0 +1,43 @@
+#pragma once
+#include "../include/EnigmaMachine.hpp"
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MessageEditor {
+public:
+  static constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 256;
+
+  explicit MessageEditor(
+      const EnigmaMachine &machine,
+      size_t checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL);
+
+  void setMachine(const EnigmaMachine &machine);
+  void insert(size_t position, const std::string &text);
+  void erase(size_t position, size_t count);
+  int replace(size_t position, const std::string &text);
+
+  const std::string &getPlaintext() const;
+  const std::string &getCiphertext() const;
+  size_t getLastEncryptedCount() const;
+  size_t getLastWalkedCount() const;
+
+private:
+  using Positions = std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>;
+
+  void invalidateCheckpoints(size_t position);
+  void restore(size_t position);
+  void encryptRange(size_t first, size_t last);
+  void advance(size_t index, bool encrypt);
+
+  EnigmaMachine machine_;
+  size_t checkpointInterval_ = DEFAULT_CHECKPOINT_INTERVAL;
+  std::vector<Positions> checkpoints_;
+  std::string plaintext_ = "";
+  std::string ciphertext_ = "";
+  size_t lastEncryptedCount_ = 0;
+  size_t lastWalkedCount_ = 0;
+};
+
+int runMessageEditor(const std::string &path, size_t checkpointInterval);
@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Permutation {
+public:
+  static constexpr unsigned int SIZE = 26;
+  static constexpr unsigned int LANES = 32;
+
+  Permutation();
+
+  static Permutation fromSymbols(const char *symbols);
+  static Permutation shift(int offset);
+  static Permutation transposition(unsigned int a, unsigned int b);
+
+  uint8_t operator[](unsigned int index) const { return images_[index]; }
+  bool operator==(const Permutation &other) const;
+
+  Permutation then(const Permutation &next) const;
+  Permutation inverse() const;
+  Permutation conjugateByShift(int offset) const;
+
+  bool isInvolution() const;
+  unsigned int getFixedPointCount() const;
+  void getCycleLengths(std::vector<unsigned int> &lengths) const;
+  std::string describeCycles() const;
+
+private:
+  alignas(LANES) std::array<uint8_t, LANES> images_;
+};
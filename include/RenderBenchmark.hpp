@@ -0,0 +1,4 @@
+#pragma once
+
+int runRenderBenchmark(unsigned int keys, unsigned int rows,
+                       unsigned int columns);
@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+
+int startRecording(const std::string &path);
+int startReplay(const std::string &path, bool realTime);
+bool isReplaying();
+bool isReplayFinished();
+bool isFullSpeedReplay();
+int setupReplayTerminal();
+
+int readKey();
+void markFrame();
+void finishSession();
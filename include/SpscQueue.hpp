@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity> class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+public:
+  bool push(const T &value) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - headCache_ == Capacity) {
+      headCache_ = head_.load(std::memory_order_acquire);
+      if (tail - headCache_ == Capacity) {
+        return false;
+      }
+    }
+    buffer_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &value) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tailCache_) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head == tailCache_) {
+        return false;
+      }
+    }
+    value = buffer_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  alignas(64) std::atomic<size_t> head_ = 0;
+  size_t tailCache_ = 0;
+  alignas(64) std::atomic<size_t> tail_ = 0;
+  size_t headCache_ = 0;
+  alignas(64) std::array<T, Capacity> buffer_ = {};
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+class TextFormat {
+public:
+  enum Policy { FILTER, PASS_THROUGH, HISTORICAL };
+
+  static constexpr unsigned int MAX_EXPANSION = 6;
+  static constexpr unsigned int GROUP_LENGTH = 5;
+  static constexpr unsigned int GROUPS_PER_LINE = 10;
+
+  static size_t normalise(const char *input, size_t length, char *output,
+                          Policy policy);
+
+  explicit TextFormat(unsigned int groupLength = GROUP_LENGTH,
+                      unsigned int groupsPerLine = GROUPS_PER_LINE);
+
+  size_t group(const char *letters, size_t length, char *output);
+  size_t finish(char *output);
+  size_t getMaxGroupedLength(size_t length) const;
+
+private:
+  unsigned int groupLength_ = GROUP_LENGTH;
+  unsigned int lineLength_ = GROUP_LENGTH * GROUPS_PER_LINE;
+  unsigned int column_ = 0;
+  unsigned int groupColumn_ = 0;
+};
+
+int encryptFile(const std::string &path, TextFormat::Policy policy,
+                bool grouped);
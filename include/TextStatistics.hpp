@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TextStatistics {
+public:
+  static constexpr unsigned int LETTERS = 26;
+
+  void add(char previous, char letter);
+  void remove(char previous, char letter);
+  void addText(const char *text, size_t length, char &previous);
+  void merge(const TextStatistics &other);
+  void clear();
+
+  uint64_t getLetterCount() const;
+  uint64_t getFrequency(char letter) const;
+  uint64_t getBigramCount(char first, char second) const;
+  double getIndexOfCoincidence() const;
+  std::vector<std::pair<std::string, uint64_t>>
+  getTopBigrams(unsigned int limit) const;
+
+private:
+  static int getIndex(char letter);
+
+  std::array<uint64_t, LETTERS> frequencies_ = {};
+  std::array<uint64_t, LETTERS * LETTERS> bigrams_ = {};
+  uint64_t letterCount_ = 0;
+  uint64_t coincidences_ = 0;
+};
+
+int printTextStatistics(const std::string &path);
@@ -0,0 +1,44 @@
+#pragma once
+#include "../include/EnigmaMachine.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct TrafficKey {
+  std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> order = {};
+  std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> positions = {};
+  std::vector<std::pair<char, char>> plugs;
+
+  void apply(EnigmaMachine &machine) const;
+  std::string describe(EnigmaMachine machine) const;
+};
+
+class TrafficGenerator {
+public:
+  struct Options {
+    uint64_t seed = 1;
+    unsigned int messages = 10000;
+    unsigned int length = 250;
+    unsigned int shards = 16;
+    unsigned int threads = 0;
+  };
+
+  explicit TrafficGenerator(const Options &options);
+
+  TrafficKey generateKey(uint64_t &state) const;
+  void generatePlaintext(uint64_t &state, std::string &plaintext) const;
+  void generateMessage(uint64_t index, TrafficKey &key, std::string &plaintext,
+                       std::string &ciphertext) const;
+  int writeShard(const std::string &directory, unsigned int shard,
+                 uint64_t &bytes) const;
+
+private:
+  Options options_;
+  EnigmaMachine machine_ = setupEnigmaMachine();
+  std::vector<uint32_t> cumulativeWeights_;
+};
+
+int generateTraffic(const std::string &directory,
+                    const TrafficGenerator::Options &options);
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+template <typename T> class TripleBuffer {
+public:
+  explicit TripleBuffer(const T &initial)
+      : slots_{initial, initial, initial} {}
+
+  T &getBack() { return slots_[back_]; }
+
+  void publish() {
+    back_ = middle_.exchange(back_ | DIRTY_, std::memory_order_acq_rel) &
+            INDEX_;
+  }
+
+  bool update() {
+    if (!(middle_.load(std::memory_order_relaxed) & DIRTY_)) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_;
+    return true;
+  }
+
+  const T &getFront() const { return slots_[front_]; }
+
+private:
+  static constexpr unsigned int DIRTY_ = 4;
+  static constexpr unsigned int INDEX_ = 3;
+
+  std::array<T, 3> slots_;
+  unsigned int back_ = 0;
+  unsigned int front_ = 1;
+  std::atomic<unsigned int> middle_ = 2;
+};
@@ -0,0 +1,228 @@
+#include "../include/Banburismus.hpp"
+#include "../include/TextFormat.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const unsigned int BLOCK = 16;
+const unsigned int MAX_BLOCKS_PER_SUM = 255;
+const unsigned int LETTERS = 26;
+
+typedef uint8_t Block __attribute__((vector_size(BLOCK)));
+
+const double HIT_WEIGHT =
+    10.0 * std::log10(Banburismus::PLAINTEXT_COINCIDENCE /
+                      Banburismus::RANDOM_COINCIDENCE);
+const double MISS_WEIGHT =
+    10.0 * std::log10((1.0 - Banburismus::PLAINTEXT_COINCIDENCE) /
+                      (1.0 - Banburismus::RANDOM_COINCIDENCE));
+
+bool isBetter(const OverlapMatch &a, const OverlapMatch &b) {
+  if (a.score != b.score) {
+    return a.score > b.score;
+  } else if (a.first != b.first) {
+    return a.first < b.first;
+  } else if (a.second != b.second) {
+    return a.second < b.second;
+  }
+  return a.offset < b.offset;
+}
+
+void keepMatch(std::vector<OverlapMatch> &best, unsigned int limit,
+               const OverlapMatch &match) {
+  if (best.size() < limit) {
+    best.push_back(match);
+    std::push_heap(best.begin(), best.end(), isBetter);
+  } else if (limit > 0 && isBetter(match, best.front())) {
+    std::pop_heap(best.begin(), best.end(), isBetter);
+    best.back() = match;
+    std::push_heap(best.begin(), best.end(), isBetter);
+  }
+}
+
+Block loadBlock(const char *text) {
+  Block block;
+  memcpy(&block, text, sizeof(block));
+  return block;
+}
+
+uint32_t sumBlock(Block block) {
+  uint64_t halves[2];
+  memcpy(halves, &block, sizeof(halves));
+  uint32_t sum = 0;
+  for (const uint64_t half : halves) {
+    uint64_t pairs = (half & 0x00FF00FF00FF00FFull) +
+                     ((half >> 8) & 0x00FF00FF00FF00FFull);
+    sum += (pairs * 0x0001000100010001ull) >> 48;
+  }
+  return sum;
+}
+
+} // namespace
+
+Banburismus::Banburismus(const std::vector<std::string> &messages,
+                         unsigned int minOverlap)
+    : messages_(messages), minOverlap_(std::max(1u, minOverlap)) {}
+
+uint32_t Banburismus::countCoincidences(const char *first, const char *second,
+                                        size_t length) {
+  uint32_t coincidences = 0;
+  size_t i = 0;
+  while (i + BLOCK <= length) {
+    Block counts = {};
+    for (unsigned int blocks = 0;
+         blocks < MAX_BLOCKS_PER_SUM && i + BLOCK <= length;
+         ++blocks, i += BLOCK) {
+      counts -= (Block)(loadBlock(first + i) == loadBlock(second + i));
+    }
+    coincidences += sumBlock(counts);
+  }
+  for (; i < length; ++i) {
+    coincidences += first[i] == second[i];
+  }
+  return coincidences;
+}
+
+double Banburismus::getWeight(uint32_t overlap, uint32_t coincidences) {
+  return coincidences * HIT_WEIGHT + (overlap - coincidences) * MISS_WEIGHT;
+}
+
+uint64_t Banburismus::getComparisonCount() const {
+  uint64_t comparisons = 0;
+  for (size_t i = 0; i < messages_.size(); ++i) {
+    for (size_t j = i + 1; j < messages_.size(); ++j) {
+      comparisons += (uint64_t)messages_[i].length() * messages_[j].length();
+    }
+  }
+  return comparisons;
+}
+
+void Banburismus::scorePair(uint32_t first, uint32_t second,
+                            std::vector<OverlapMatch> &best,
+                            unsigned int limit) const {
+  const std::string &a = messages_[first];
+  const std::string &b = messages_[second];
+  int32_t lowest = -(int32_t)b.length() + (int32_t)minOverlap_;
+  int32_t highest = (int32_t)a.length() - (int32_t)minOverlap_;
+
+  for (int32_t offset = lowest; offset <= highest; ++offset) {
+    size_t firstStart = std::max(offset, 0);
+    size_t secondStart = std::max(-offset, 0);
+    uint32_t overlap =
+        std::min(a.length() - firstStart, b.length() - secondStart);
+    uint32_t coincidences = countCoincidences(
+        a.data() + firstStart, b.data() + secondStart, overlap);
+    keepMatch(best, limit,
+              {getWeight(overlap, coincidences), first, second, offset,
+               overlap, coincidences});
+  }
+}
+
+std::vector<OverlapMatch> Banburismus::score(unsigned int limit,
+                                             unsigned int threads) const {
+  const uint32_t tiles =
+      (messages_.size() + MESSAGES_PER_TILE - 1) / MESSAGES_PER_TILE;
+  std::vector<std::pair<uint32_t, uint32_t>> tilePairs;
+  for (uint32_t i = 0; i < tiles; ++i) {
+    for (uint32_t j = i; j < tiles; ++j) {
+      tilePairs.push_back({i, j});
+    }
+  }
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::max<size_t>(1, std::min<size_t>(threads, tilePairs.size()));
+
+  std::vector<std::vector<OverlapMatch>> best(threads);
+  std::atomic<size_t> nextTile = 0;
+  auto work = [&](unsigned int thread) {
+    size_t tile = 0;
+    while ((tile = nextTile.fetch_add(1)) < tilePairs.size()) {
+      uint32_t firstBegin = tilePairs[tile].first * MESSAGES_PER_TILE;
+      uint32_t secondBegin = tilePairs[tile].second * MESSAGES_PER_TILE;
+      uint32_t firstEnd = std::min<size_t>(firstBegin + MESSAGES_PER_TILE,
+                                           messages_.size());
+      uint32_t secondEnd = std::min<size_t>(secondBegin + MESSAGES_PER_TILE,
+                                            messages_.size());
+      for (uint32_t i = firstBegin; i < firstEnd; ++i) {
+        for (uint32_t j = std::max(secondBegin, i + 1); j < secondEnd; ++j) {
+          scorePair(i, j, best[thread], limit);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i) {
+    workers.emplace_back(work, i);
+  }
+  work(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  std::vector<OverlapMatch> results;
+  for (const auto &threadBest : best) {
+    for (const auto &match : threadBest) {
+      keepMatch(results, limit, match);
+    }
+  }
+  std::sort(results.begin(), results.end(), isBetter);
+  return results;
+}
+
+int printBanburismus(const std::string &path, unsigned int minOverlap,
+                     unsigned int limit, unsigned int threads) {
+  FILE *file = path == "-" ? stdin : fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> messages;
+  char *line = nullptr;
+  size_t capacity = 0;
+  ssize_t length = 0;
+  while ((length = getline(&line, &capacity, file)) != -1) {
+    std::string message(length, '\0');
+    message.resize(TextFormat::normalise(line, length, message.data(),
+                                         TextFormat::FILTER));
+    if (!message.empty()) {
+      messages.push_back(message);
+    }
+  }
+  free(line);
+  if (file != stdin) {
+    fclose(file);
+  }
+
+  Banburismus banburismus(messages, minOverlap);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<OverlapMatch> matches = banburismus.score(limit, threads);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  uint64_t comparisons = banburismus.getComparisonCount();
+  fprintf(stderr, "messages=%zu comparisons=%llu (%.2fs, %.2f G/s)\n",
+          messages.size(), (unsigned long long)comparisons, seconds,
+          seconds > 0.0 ? comparisons / seconds / 1e9 : 0.0);
+
+  printf("%8s %6s %6s %7s %7s %5s  %s\n", "decibans", "first", "second",
+         "offset", "overlap", "hits", "right rotor candidate");
+  for (const auto &match : matches) {
+    int shift = ((match.offset % (int)LETTERS) + LETTERS) % LETTERS;
+    printf("%8.1f %6u %6u %7d %7u %5u  start[%u] = start[%u] - %d\n",
+           match.score, match.first, match.second, match.offset,
+           match.overlap, match.coincidences, match.second, match.first,
+           shift);
+  }
+  return 0;
+}
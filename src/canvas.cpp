@@ -0,0 +1,134 @@
+#include "../include/Canvas.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+void Canvas::print(unsigned int y, unsigned int x, const char *format, ...) {
+  char buffer[512];
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, arguments);
+  va_end(arguments);
+
+  if (length > 0) {
+    write(y, x, buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+  }
+}
+
+void Canvas::setStyle(unsigned int style) {
+  style_ = style;
+  applyStyle();
+}
+
+void Canvas::addStyle(unsigned int style) { setStyle(style_ | style); }
+
+void Canvas::removeStyle(unsigned int style) { setStyle(style_ & ~style); }
+
+unsigned int Canvas::getStyle() const { return style_; }
+
+NcursesCanvas::NcursesCanvas(WINDOW *window) : window_(window) {}
+
+unsigned int NcursesCanvas::getHeight() const { return getmaxy(window_); }
+
+unsigned int NcursesCanvas::getWidth() const { return getmaxx(window_); }
+
+void NcursesCanvas::write(unsigned int y, unsigned int x, const char *text,
+                          size_t length) {
+  mvwaddnstr(window_, y, x, text, length);
+}
+
+void NcursesCanvas::erase() { werase(window_); }
+
+void NcursesCanvas::clear() { wclear(window_); }
+
+void NcursesCanvas::drawBox() { box(window_, '|', '-'); }
+
+void NcursesCanvas::refresh() { wrefresh(window_); }
+
+void NcursesCanvas::applyStyle() {
+  attr_t attributes = A_NORMAL;
+  if (style_ & BOLD) {
+    attributes |= A_BOLD;
+  }
+  if (style_ & DIM) {
+    attributes |= A_DIM;
+  }
+  if (style_ & SELECTED) {
+    attributes |= COLOR_PAIR(1);
+  } else if (style_ & ACTIVE) {
+    attributes |= COLOR_PAIR(2);
+  }
+  wattrset(window_, attributes);
+}
+
+MemoryCanvas::MemoryCanvas(unsigned int height, unsigned int width)
+    : height_(height), width_(width), cells_(height * width) {}
+
+unsigned int MemoryCanvas::getHeight() const { return height_; }
+
+unsigned int MemoryCanvas::getWidth() const { return width_; }
+
+void MemoryCanvas::write(unsigned int y, unsigned int x, const char *text,
+                         size_t length) {
+  if (y >= height_) {
+    return;
+  }
+  for (size_t i = 0; i < length && x + i < width_; ++i) {
+    cells_[y * width_ + x + i] = {text[i], (uint8_t)style_};
+  }
+}
+
+void MemoryCanvas::erase() { std::fill(cells_.begin(), cells_.end(), Cell{}); }
+
+void MemoryCanvas::clear() { erase(); }
+
+void MemoryCanvas::drawBox() {
+  if (height_ < 2 || width_ < 2) {
+    return;
+  }
+  for (unsigned int x = 0; x < width_; ++x) {
+    cells_[x] = {'-', (uint8_t)style_};
+    cells_[(height_ - 1) * width_ + x] = {'-', (uint8_t)style_};
+  }
+  for (unsigned int y = 0; y < height_; ++y) {
+    cells_[y * width_] = {'|', (uint8_t)style_};
+    cells_[y * width_ + width_ - 1] = {'|', (uint8_t)style_};
+  }
+  for (const unsigned int corner : {0u, width_ - 1, (height_ - 1) * width_,
+                                    height_ * width_ - 1}) {
+    cells_[corner] = {'+', (uint8_t)style_};
+  }
+}
+
+void MemoryCanvas::refresh() { refreshCount_++; }
+
+const Cell &MemoryCanvas::getCell(unsigned int y, unsigned int x) const {
+  return cells_[y * width_ + x];
+}
+
+size_t MemoryCanvas::countChangedCells(const MemoryCanvas &previous) const {
+  if (previous.cells_.size() != cells_.size()) {
+    return cells_.size();
+  }
+  size_t changed = 0;
+  for (size_t i = 0; i < cells_.size(); ++i) {
+    changed += !(cells_[i] == previous.cells_[i]);
+  }
+  return changed;
+}
+
+unsigned long long MemoryCanvas::getRefreshCount() const {
+  return refreshCount_;
+}
+
+std::string MemoryCanvas::toString() const {
+  std::string frame;
+  frame.reserve(height_ * (width_ + 1));
+  for (unsigned int y = 0; y < height_; ++y) {
+    for (unsigned int x = 0; x < width_; ++x) {
+      frame += cells_[y * width_ + x].symbol;
+    }
+    frame += '\n';
+  }
+  return frame;
+}
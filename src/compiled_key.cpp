@@ -0,0 +1,165 @@
+#include "../include/CompiledKey.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace {
+
+const unsigned int LETTERS = 26;
+
+} // namespace
+
+CompiledKey::CompiledKey(const EnigmaMachine &machine)
+    : permutations_(POSITIONS), next_(POSITIONS), previous_(POSITIONS) {
+  EnigmaMachine stepper = machine;
+  stepper.setRotorPositions({0, 0, 0});
+  const Rotor &outer = stepper.getActiveRotors()[0];
+  Permutation plugBoard = stepper.getPlugBoardPermutation();
+  Permutation entry = plugBoard.then(outer.getPermutation(-1));
+  Permutation exit = outer.getPermutation(1).then(plugBoard.inverse());
+
+  for (unsigned int inner = 0; inner < LETTERS * LETTERS; ++inner) {
+    stepper.setRotorPositions({0, inner / LETTERS, inner % LETTERS});
+    Permutation core = stepper.getRotorPermutation(1);
+    for (unsigned int position = 0; position < LETTERS; ++position) {
+      permutations_[position * LETTERS * LETTERS + inner] =
+          entry.then(core.conjugateByShift(-position)).then(exit);
+    }
+  }
+
+  for (unsigned int state = 0; state < POSITIONS; ++state) {
+    KeyCursor cursor = {(uint16_t)state};
+    stepper.setRotorPositions(getPositions(cursor));
+    stepper.spinRotors(-1);
+    next_[state] = getCursor(stepper.getRotorPositions()).state;
+
+    stepper.setRotorPositions(getPositions(cursor));
+    stepper.spinRotors(1);
+    previous_[state] = getCursor(stepper.getRotorPositions()).state;
+  }
+}
+
+std::shared_ptr<const CompiledKey>
+CompiledKey::compile(const EnigmaMachine &machine) {
+  return std::make_shared<const CompiledKey>(machine);
+}
+
+KeyCursor CompiledKey::getCursor(
+    const std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> &positions) {
+  return {(uint16_t)(((positions[0] % LETTERS) * LETTERS +
+                      positions[1] % LETTERS) *
+                         LETTERS +
+                     positions[2] % LETTERS)};
+}
+
+std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>
+CompiledKey::getPositions(KeyCursor cursor) {
+  return {cursor.state / (LETTERS * LETTERS),
+          (cursor.state / LETTERS) % LETTERS, cursor.state % LETTERS};
+}
+
+char CompiledKey::encrypt(KeyCursor &cursor, char letter) const {
+  char encrypted = 'A' + permutations_[cursor.state][letter - 'A'];
+  cursor.state = next_[cursor.state];
+  return encrypted;
+}
+
+void CompiledKey::encryptText(KeyCursor &cursor, char *text,
+                              size_t length) const {
+  for (size_t i = 0; i < length; ++i) {
+    unsigned int letter = (unsigned char)(text[i] | 0x20) - 'a';
+    if (letter < LETTERS) {
+      text[i] = encrypt(cursor, 'A' + letter);
+    }
+  }
+}
+
+void CompiledKey::encryptText(KeyCursor &cursor, std::string &text) const {
+  encryptText(cursor, text.data(), text.length());
+}
+
+void CompiledKey::step(KeyCursor &cursor, int direction) const {
+  if (direction == -1) {
+    cursor.state = next_[cursor.state];
+  } else if (direction == 1) {
+    cursor.state = previous_[cursor.state];
+  }
+}
+
+size_t CompiledKey::getTableBytes() {
+  return POSITIONS * (sizeof(Permutation) + 2 * sizeof(uint16_t));
+}
+
+int runCursorBenchmark(unsigned int threads, unsigned int length) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  EnigmaMachine machine = setupEnigmaMachine();
+  machine.setRotorOrder({3, 0, 4});
+  machine.setRotorPositions({7, 19, 2});
+  machine.setCable(0, 'A', 'Q');
+  machine.setCable(1, 'E', 'Z');
+
+  auto compileStart = std::chrono::steady_clock::now();
+  std::shared_ptr<const CompiledKey> key = CompiledKey::compile(machine);
+  const KeyCursor startCursor = key->getCursor(machine.getRotorPositions());
+  double compileSeconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - compileStart)
+                              .count();
+
+  std::vector<std::string> texts(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    std::mt19937 generator(i);
+    texts[i].resize(length);
+    for (auto &letter : texts[i]) {
+      letter = 'A' + generator() % LETTERS;
+    }
+  }
+
+  auto run = [&](bool compiled, std::vector<std::string> &outputs) {
+    outputs = texts;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; ++i) {
+      workers.emplace_back([&, i] {
+        if (compiled) {
+          KeyCursor cursor = startCursor;
+          key->encryptText(cursor, outputs[i]);
+        } else {
+          EnigmaMachine copy = machine;
+          copy.encryptText(outputs[i]);
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return seconds > 0.0 ? (double)threads * length / seconds / 1e6 : 0.0;
+  };
+
+  std::vector<std::string> machineOutputs, cursorOutputs;
+  double machineRate = run(false, machineOutputs);
+  double cursorRate = run(true, cursorOutputs);
+
+  printf("threads=%u letters/thread=%u\n", threads, length);
+  size_t machineBytes =
+      sizeof(EnigmaMachine) +
+      machine.getAvaliableRotors().size() * sizeof(Rotor) +
+      machine.getActivePlugs().size() * sizeof(Cable) + sizeof(Reflector);
+  printf("machine copies: %8.1f M letters/s, %zu bytes per stream\n",
+         machineRate, machineBytes);
+  printf("shared key:     %8.1f M letters/s, %zu bytes per stream, "
+         "%zu KiB table compiled once in %.1fms\n",
+         cursorRate, sizeof(KeyCursor), key->getTableBytes() / 1024,
+         compileSeconds * 1000.0);
+  if (machineOutputs != cursorOutputs) {
+    fprintf(stderr, "Compiled key output differs from the machine\n");
+    return 1;
+  }
+  return 0;
+}
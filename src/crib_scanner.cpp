@@ -0,0 +1,189 @@
+#include "../include/CribScanner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const unsigned int BLOCK = 16;
+const unsigned int WORD_BITS = 64;
+
+typedef char Block __attribute__((vector_size(BLOCK)));
+
+Block loadBlock(const char *text) {
+  Block block;
+  __builtin_memcpy(&block, text, sizeof(block));
+  return block;
+}
+
+uint32_t getConflictMask(Block conflicts) {
+#ifdef __SSE2__
+  return _mm_movemask_epi8((__m128i)conflicts);
+#else
+  uint32_t mask = 0;
+  for (unsigned int i = 0; i < BLOCK; ++i) {
+    mask |= (conflicts[i] != 0) << i;
+  }
+  return mask;
+#endif
+}
+
+} // namespace
+
+CribScanner::CribScanner(const std::string &crib) : crib_(crib) {
+  for (auto &letter : crib_) {
+    letter = toupper((unsigned char)letter);
+  }
+  for (size_t i = 0; i < crib_.length() && i < MAX_CRIB_LENGTH; ++i) {
+    letterMasks_[(unsigned char)crib_[i]] |= 1ull << i;
+  }
+}
+
+bool CribScanner::isValid() const {
+  return !crib_.empty() && crib_.length() <= MAX_CRIB_LENGTH &&
+         std::all_of(crib_.begin(), crib_.end(), [](char letter) {
+           return letter >= 'A' && letter <= 'Z';
+         });
+}
+
+size_t CribScanner::getCribLength() const { return crib_.length(); }
+
+std::vector<uint64_t> CribScanner::scan(const char *text, size_t length,
+                                        unsigned int threads) const {
+  if (!isValid() || length < crib_.length()) {
+    return {};
+  }
+
+  const size_t offsets = length - crib_.length() + 1;
+  std::vector<uint64_t> positions((offsets + WORD_BITS - 1) / WORD_BITS, 0);
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const size_t MIN_WORDS_PER_THREAD = 1024;
+  threads = std::max<size_t>(
+      1, std::min<size_t>(threads, positions.size() / MIN_WORDS_PER_THREAD));
+
+  size_t wordsPerThread = (positions.size() + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i) {
+    size_t first = std::min(offsets, i * wordsPerThread * WORD_BITS);
+    size_t last = std::min(offsets, (i + 1) * wordsPerThread * WORD_BITS);
+    workers.emplace_back(&CribScanner::scanRange, this, text, length, first,
+                         last, positions.data());
+  }
+  scanRange(text, length, 0, std::min(offsets, wordsPerThread * WORD_BITS),
+            positions.data());
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  return positions;
+}
+
+void CribScanner::scanRange(const char *text, size_t length, size_t first,
+                            size_t last, uint64_t *positions) const {
+  const size_t cribLength = crib_.length();
+
+  std::array<Block, MAX_CRIB_LENGTH> cribBlocks;
+  for (size_t i = 0; i < cribLength; ++i) {
+    cribBlocks[i] = Block{} + crib_[i];
+  }
+
+  size_t offset = first;
+  for (; offset + BLOCK + cribLength - 1 <= length && offset + BLOCK <= last;
+       offset += BLOCK) {
+    Block conflicts = {};
+    for (size_t i = 0; i < cribLength; ++i) {
+      conflicts |= loadBlock(text + offset + i) == cribBlocks[i];
+    }
+
+    uint64_t legal = (~getConflictMask(conflicts)) & 0xFFFF;
+    positions[offset / WORD_BITS] |= legal << (offset % WORD_BITS);
+  }
+
+  if (offset < last) {
+    scanRangeBitParallel(text, offset, last, positions);
+  }
+}
+
+void CribScanner::scanRangeBitParallel(const char *text, size_t first,
+                                       size_t last,
+                                       uint64_t *positions) const {
+  const size_t cribLength = crib_.length();
+  const uint64_t lastBit = 1ull << (cribLength - 1);
+
+  uint64_t conflicts = 0;
+  for (size_t i = first; i < last + cribLength - 1; ++i) {
+    conflicts = (conflicts << 1) | letterMasks_[(unsigned char)text[i]];
+    if (i + 1 >= first + cribLength && !(conflicts & lastBit)) {
+      size_t offset = i + 1 - cribLength;
+      positions[offset / WORD_BITS] |= 1ull << (offset % WORD_BITS);
+    }
+  }
+}
+
+uint64_t CribScanner::countPositions(const std::vector<uint64_t> &positions) {
+  uint64_t count = 0;
+  for (const uint64_t word : positions) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+int printCribPositions(const std::string &path, const std::string &crib,
+                       bool countOnly) {
+  CribScanner scanner(crib);
+  if (!scanner.isValid()) {
+    fprintf(stderr, "Crib must be 1 to %u letters\n",
+            CribScanner::MAX_CRIB_LENGTH);
+    return 1;
+  }
+
+  FILE *file = path == "-" ? stdin : fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  std::string text;
+  const size_t CHUNK_SIZE = 1 << 20;
+  std::vector<char> chunk(CHUNK_SIZE);
+  size_t length = 0;
+  while ((length = fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+    for (size_t i = 0; i < length; ++i) {
+      unsigned int index = (unsigned char)(chunk[i] | 0x20) - 'a';
+      if (index < 26) {
+        text += (char)('A' + index);
+      }
+    }
+  }
+  if (file != stdin) {
+    fclose(file);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint64_t> positions = scanner.scan(text.data(), text.length());
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  fprintf(stderr, "letters=%zu legal=%llu (%.2f GB/s)\n", text.length(),
+          (unsigned long long)CribScanner::countPositions(positions),
+          seconds > 0.0 ? text.length() / seconds / 1e9 : 0.0);
+
+  if (!countOnly) {
+    for (size_t word = 0; word < positions.size(); ++word) {
+      uint64_t bits = positions[word];
+      while (bits) {
+        printf("%zu\n", word * WORD_BITS + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+  return 0;
+}
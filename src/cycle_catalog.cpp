@@ -0,0 +1,483 @@
+#include "../include/CycleCatalog.hpp"
+#include "../include/CompiledKey.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const uint32_t MAGIC[2] = {0x47494E45, 0x31435943}; // "ENIGCYC1"
+const unsigned int HEADER_WORDS = 6;
+const unsigned int LETTERS = 26;
+const unsigned int HALF_LETTERS = LETTERS / 2;
+
+using Partition = std::vector<unsigned int>;
+
+void addPartitions(std::vector<Partition> &partitions, Partition &current,
+                   unsigned int remaining, unsigned int largest) {
+  if (remaining == 0) {
+    partitions.push_back(current);
+    return;
+  }
+  for (unsigned int part = std::min(remaining, largest); part > 0; --part) {
+    current.push_back(part);
+    addPartitions(partitions, current, remaining - part, part);
+    current.pop_back();
+  }
+}
+
+const std::vector<Partition> &getPartitions() {
+  static const std::vector<Partition> partitions = [] {
+    std::vector<Partition> result;
+    Partition current;
+    addPartitions(result, current, HALF_LETTERS, HALF_LETTERS);
+    return result;
+  }();
+  return partitions;
+}
+
+uint64_t packPartition(const unsigned int *parts, size_t count) {
+  uint64_t key = 0;
+  for (size_t i = 0; i < count; ++i) {
+    key = (key << 4) | parts[i];
+  }
+  return key;
+}
+
+uint32_t getPartitionIndex(std::vector<unsigned int> &cycleLengths) {
+  static const std::unordered_map<uint64_t, uint32_t> indexes = [] {
+    std::unordered_map<uint64_t, uint32_t> result;
+    const auto &partitions = getPartitions();
+    for (size_t i = 0; i < partitions.size(); ++i) {
+      result[packPartition(partitions[i].data(), partitions[i].size())] = i;
+    }
+    return result;
+  }();
+
+  std::sort(cycleLengths.rbegin(), cycleLengths.rend());
+
+  std::array<unsigned int, HALF_LETTERS> halved = {};
+  size_t parts = 0;
+  for (size_t i = 0; i < cycleLengths.size(); i += 2) {
+    if (i + 1 >= cycleLengths.size() ||
+        cycleLengths[i] != cycleLengths[i + 1] || parts == halved.size()) {
+      return CycleCatalog::INVALID_SIGNATURE;
+    }
+    halved[parts++] = cycleLengths[i];
+  }
+
+  auto it = indexes.find(packPartition(halved.data(), parts));
+  if (it == indexes.end()) {
+    return CycleCatalog::INVALID_SIGNATURE;
+  }
+  return it->second;
+}
+
+uint32_t getProductIndex(const Permutation &first,
+                         const Permutation &second) {
+  thread_local std::vector<unsigned int> cycleLengths;
+  first.then(second).getCycleLengths(cycleLengths);
+  return getPartitionIndex(cycleLengths);
+}
+
+uint32_t combineSignature(uint32_t ad, uint32_t be, uint32_t cf) {
+  if (ad == CycleCatalog::INVALID_SIGNATURE ||
+      be == CycleCatalog::INVALID_SIGNATURE ||
+      cf == CycleCatalog::INVALID_SIGNATURE) {
+    return CycleCatalog::INVALID_SIGNATURE;
+  }
+  uint32_t base = getPartitions().size();
+  return (ad * base + be) * base + cf;
+}
+
+void computeOrderSignatures(
+    EnigmaMachine machine,
+    const std::array<unsigned int, EnigmaMachine::MAX_ROTORS_> &order,
+    std::vector<uint32_t> &signatures) {
+  machine.setRotorOrder(order);
+  const CompiledKey key(machine);
+
+  signatures.resize(CycleCatalog::POSITIONS);
+  for (unsigned int state = 0; state < CycleCatalog::POSITIONS; ++state) {
+    std::array<const Permutation *, 6> permutations = {};
+    KeyCursor cursor = {(uint16_t)state};
+    for (auto &permutation : permutations) {
+      permutation = &key.getPermutation(cursor);
+      cursor = key.getNext(cursor);
+    }
+    signatures[state] = combineSignature(
+        getProductIndex(*permutations[0], *permutations[3]),
+        getProductIndex(*permutations[1], *permutations[4]),
+        getProductIndex(*permutations[2], *permutations[5]));
+  }
+}
+
+bool isValidOrder(uint32_t packedOrder, uint32_t rotorCount) {
+  std::array<uint32_t, EnigmaMachine::MAX_ROTORS_> order = {
+      packedOrder & 0xFF, (packedOrder >> 8) & 0xFF,
+      (packedOrder >> 16) & 0xFF};
+  return (packedOrder >> 24) == 0 && order[0] < rotorCount &&
+         order[1] < rotorCount && order[2] < rotorCount &&
+         order[0] != order[1] && order[1] != order[2] && order[0] != order[2];
+}
+
+bool isValidCatalog(const uint32_t *words, size_t length) {
+  const uint64_t rotorCount = words[2];
+  const uint64_t orderCount = words[3];
+  const uint64_t signatureCount = words[4];
+  const uint64_t settingCount = words[5];
+  const uint64_t expectedWords =
+      HEADER_WORDS + orderCount + signatureCount * 2 + settingCount;
+  if (words[0] != MAGIC[0] || words[1] != MAGIC[1] ||
+      rotorCount < EnigmaMachine::MAX_ROTORS_ || rotorCount > 0xFF ||
+      orderCount == 0 ||
+      orderCount > rotorCount * (rotorCount - 1) * (rotorCount - 2) ||
+      settingCount > orderCount * CycleCatalog::POSITIONS ||
+      expectedWords * sizeof(uint32_t) != length) {
+    return false;
+  }
+
+  const uint32_t *orders = words + HEADER_WORDS;
+  for (uint64_t i = 0; i < orderCount; ++i) {
+    if (!isValidOrder(orders[i], rotorCount)) {
+      return false;
+    }
+  }
+
+  const uint64_t base = getPartitions().size();
+  const uint32_t *index = orders + orderCount;
+  for (uint64_t i = 0; i < signatureCount; ++i) {
+    const uint32_t signature = index[i * 2];
+    const uint32_t offset = index[i * 2 + 1];
+    if (signature >= base * base * base || offset > settingCount ||
+        (i == 0 && offset != 0) ||
+        (i > 0 && (signature <= index[i * 2 - 2] ||
+                   offset < index[i * 2 - 1]))) {
+      return false;
+    }
+  }
+
+  const uint32_t *entries = index + signatureCount * 2;
+  return std::all_of(entries, entries + settingCount, [&](uint32_t setting) {
+    return setting < orderCount * CycleCatalog::POSITIONS;
+  });
+}
+
+} // namespace
+
+CycleCatalog::~CycleCatalog() { close(); }
+
+int CycleCatalog::build(const EnigmaMachine &machine, const std::string &path,
+                        unsigned int threads) {
+  const unsigned int rotorCount = machine.getAvaliableRotors().size();
+  const auto orders = machine.getRotorOrders();
+  if (orders.empty()) {
+    return 1;
+  }
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min<unsigned int>(threads, orders.size());
+
+  std::vector<std::vector<uint32_t>> signatures(orders.size());
+  std::atomic<size_t> nextOrder = 0;
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    workers.emplace_back([&] {
+      size_t order = 0;
+      while ((order = nextOrder.fetch_add(1)) < orders.size()) {
+        computeOrderSignatures(machine, orders[order], signatures[order]);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  const size_t base = getPartitions().size();
+  std::vector<uint32_t> counts(base * base * base + 1, 0);
+  for (const auto &orderSignatures : signatures) {
+    for (const uint32_t signature : orderSignatures) {
+      if (signature != INVALID_SIGNATURE) {
+        counts[signature]++;
+      }
+    }
+  }
+
+  std::vector<uint32_t> index;
+  std::vector<uint32_t> offsets(counts.size(), 0);
+  uint32_t entryCount = 0;
+  for (size_t signature = 0; signature < counts.size(); ++signature) {
+    if (counts[signature] == 0) {
+      continue;
+    }
+    index.push_back(signature);
+    index.push_back(entryCount);
+    offsets[signature] = entryCount;
+    entryCount += counts[signature];
+  }
+
+  std::vector<uint32_t> entries(entryCount);
+  for (size_t order = 0; order < orders.size(); ++order) {
+    for (unsigned int state = 0; state < POSITIONS; ++state) {
+      uint32_t signature = signatures[order][state];
+      if (signature != INVALID_SIGNATURE) {
+        entries[offsets[signature]++] = order * POSITIONS + state;
+      }
+    }
+  }
+
+  std::vector<uint32_t> header = {MAGIC[0],
+                                  MAGIC[1],
+                                  rotorCount,
+                                  (uint32_t)orders.size(),
+                                  (uint32_t)(index.size() / 2),
+                                  entryCount};
+  std::vector<uint32_t> packedOrders;
+  for (const auto &order : orders) {
+    packedOrders.push_back(order[0] | (order[1] << 8) | (order[2] << 16));
+  }
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+  bool written =
+      fwrite(header.data(), sizeof(uint32_t), header.size(), file) ==
+          header.size() &&
+      fwrite(packedOrders.data(), sizeof(uint32_t), packedOrders.size(),
+             file) == packedOrders.size() &&
+      fwrite(index.data(), sizeof(uint32_t), index.size(), file) ==
+          index.size() &&
+      fwrite(entries.data(), sizeof(uint32_t), entries.size(), file) ==
+          entries.size();
+  if (fclose(file) != 0 || !written) {
+    perror(path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+uint32_t
+CycleCatalog::parseSignature(const std::array<std::string, 3> &cycles) {
+  std::array<uint32_t, 3> products = {};
+  for (size_t i = 0; i < cycles.size(); ++i) {
+    std::vector<unsigned int> cycleLengths;
+    std::stringstream stream(cycles[i]);
+    std::string length;
+    unsigned int total = 0;
+    while (std::getline(stream, length, ',')) {
+      unsigned int value = strtoul(length.c_str(), nullptr, 10);
+      if (value == 0) {
+        return INVALID_SIGNATURE;
+      }
+      cycleLengths.push_back(value);
+      total += value;
+    }
+    if (total != LETTERS) {
+      return INVALID_SIGNATURE;
+    }
+    products[i] = getPartitionIndex(cycleLengths);
+  }
+  return combineSignature(products[0], products[1], products[2]);
+}
+
+std::string CycleCatalog::describeSignature(uint32_t signature) {
+  const auto &partitions = getPartitions();
+  const uint32_t base = partitions.size();
+  if (signature >= base * base * base) {
+    return "invalid";
+  }
+
+  std::array<uint32_t, 3> products = {signature / (base * base),
+                                      (signature / base) % base,
+                                      signature % base};
+  std::string description;
+  for (size_t i = 0; i < products.size(); ++i) {
+    if (i > 0) {
+      description += ' ';
+    }
+    const Partition &partition = partitions[products[i]];
+    for (size_t j = 0; j < partition.size(); ++j) {
+      if (j > 0) {
+        description += ',';
+      }
+      description += std::to_string(partition[j]) + ',' +
+                     std::to_string(partition[j]);
+    }
+  }
+  return description;
+}
+
+int CycleCatalog::open(const std::string &path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  struct stat status = {};
+  if (fstat(fd, &status) == -1) {
+    perror(path.c_str());
+    ::close(fd);
+    return 1;
+  }
+  if ((size_t)status.st_size < HEADER_WORDS * sizeof(uint32_t)) {
+    fprintf(stderr, "%s is not a cycle catalog\n", path.c_str());
+    ::close(fd);
+    return 1;
+  }
+
+  void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+
+  words_ = (const uint32_t *)mapping;
+  length_ = status.st_size;
+
+  if (!isValidCatalog(words_, length_)) {
+    fprintf(stderr, "%s is not a cycle catalog\n", path.c_str());
+    close();
+    return 1;
+  }
+
+  orders_ = words_ + HEADER_WORDS;
+  index_ = orders_ + words_[3];
+  entries_ = index_ + (size_t)words_[4] * 2;
+  return 0;
+}
+
+void CycleCatalog::close() {
+  if (words_) {
+    munmap((void *)words_, length_);
+  }
+  words_ = nullptr;
+  length_ = 0;
+  orders_ = index_ = entries_ = nullptr;
+}
+
+size_t CycleCatalog::query(uint32_t signature,
+                           const uint32_t *&settings) const {
+  settings = nullptr;
+  if (!words_) {
+    return 0;
+  }
+
+  size_t low = 0;
+  size_t high = getSignatureCount();
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (index_[middle * 2] < signature) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == getSignatureCount() || index_[low * 2] != signature) {
+    return 0;
+  }
+
+  uint32_t first = index_[low * 2 + 1];
+  uint32_t last =
+      low + 1 < getSignatureCount() ? index_[low * 2 + 3] : words_[5];
+  settings = entries_ + first;
+  return last - first;
+}
+
+CycleSetting CycleCatalog::decodeSetting(uint32_t setting) const {
+  CycleSetting decoded;
+  uint32_t packedOrder = orders_[setting / POSITIONS];
+  decoded.order = {packedOrder & 0xFF, (packedOrder >> 8) & 0xFF,
+                   (packedOrder >> 16) & 0xFF};
+  decoded.positions =
+      CompiledKey::getPositions({(uint16_t)(setting % POSITIONS)});
+  return decoded;
+}
+
+size_t CycleCatalog::getSignatureCount() const {
+  return words_ ? words_[4] : 0;
+}
+
+size_t CycleCatalog::getSettingCount() const { return words_ ? words_[5] : 0; }
+
+unsigned int CycleCatalog::getRotorCount() const {
+  return words_ ? words_[2] : 0;
+}
+
+int buildCycleCatalog(const std::string &path, unsigned int threads) {
+  auto start = std::chrono::steady_clock::now();
+  int error = CycleCatalog::build(setupEnigmaMachine(), path, threads);
+  if (error) {
+    return error;
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  CycleCatalog catalog;
+  if (catalog.open(path)) {
+    return 1;
+  }
+  printf("Wrote %s: %zu settings, %zu cycle structures in %.2fs\n",
+         path.c_str(), catalog.getSettingCount(), catalog.getSignatureCount(),
+         seconds);
+  return 0;
+}
+
+int queryCycleCatalog(const std::string &path,
+                      const std::array<std::string, 3> &cycles,
+                      unsigned int limit) {
+  uint32_t signature = CycleCatalog::parseSignature(cycles);
+  if (signature == CycleCatalog::INVALID_SIGNATURE) {
+    fprintf(stderr, "Cycle lengths must be comma separated, come in equal "
+                    "pairs and sum to 26\n");
+    return 1;
+  }
+
+  CycleCatalog catalog;
+  if (catalog.open(path)) {
+    return 1;
+  }
+  EnigmaMachine machine = setupEnigmaMachine();
+  if (catalog.getRotorCount() != machine.getAvaliableRotors().size()) {
+    fprintf(stderr, "%s was built for a machine with %u rotors\n",
+            path.c_str(), catalog.getRotorCount());
+    return 1;
+  }
+
+  const uint32_t *settings = nullptr;
+  auto start = std::chrono::steady_clock::now();
+  size_t count = catalog.query(signature, settings);
+  double microseconds = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+  printf("%s: %zu settings (%.1fus)\n",
+         CycleCatalog::describeSignature(signature).c_str(), count,
+         microseconds);
+
+  for (size_t i = 0; i < count && i < limit; ++i) {
+    CycleSetting setting = catalog.decodeSetting(settings[i]);
+    machine.setRotorOrder(setting.order);
+    machine.setRotorPositions(setting.positions);
+    printf("%s\n", machine.describeKey().c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,349 @@
+#include "../include/Daemon.hpp"
+#include "../include/CompiledKey.hpp"
+#include "../include/EnigmaMachine.hpp"
+#include "../include/KeyCache.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const unsigned int MAX_EVENTS = 256;
+const unsigned int READ_CHUNK = 64 * 1024;
+const size_t MAX_LINE_LENGTH = 1024 * 1024;
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+struct Session {
+  Session(int socketFd, KeyCursor startCursor)
+      : fd(socketFd), cursor(startCursor) {}
+
+  int fd = -1;
+  KeyCursor cursor;
+  std::string inBuffer;
+  std::string outBuffer;
+  std::vector<LatencyHistogram::Clock::time_point> pending;
+  bool writeWatched = false;
+  bool closing = false;
+};
+
+struct DaemonStats {
+  LatencyHistogram latency;
+  LatencyHistogram::Clock::time_point started = LatencyHistogram::Clock::now();
+  unsigned long long requests = 0;
+  unsigned long long letters = 0;
+  unsigned long long batches = 0;
+  unsigned long long connections = 0;
+
+  std::string summary(size_t activeSessions) const {
+    double seconds = std::chrono::duration<double>(
+                         LatencyHistogram::Clock::now() - started)
+                         .count();
+    if (seconds <= 0.0) {
+      seconds = 1e-9;
+    }
+
+    char line[192];
+    snprintf(line, sizeof(line),
+             "sessions=%zu connections=%llu requests=%llu batches=%llu "
+             "requests/s=%.0f letters/s=%.0f ",
+             activeSessions, connections, requests, batches,
+             requests / seconds, letters / seconds);
+    return line + latency.summary();
+  }
+};
+
+int setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags == -1) {
+    return 1;
+  }
+  return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1;
+}
+
+void watchWrites(int epollFd, Session &session, bool watch) {
+  if (session.writeWatched == watch) {
+    return;
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN | EPOLLRDHUP;
+  if (watch) {
+    event.events |= EPOLLOUT;
+  }
+  event.data.fd = session.fd;
+  epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+  session.writeWatched = watch;
+}
+
+void processRequests(Session &session, const CompiledKey &key,
+                     KeyCursor startCursor, DaemonStats &stats,
+                     size_t activeSessions,
+                     LatencyHistogram::Clock::time_point received) {
+  size_t start = 0;
+  size_t newline = 0;
+  while (!session.closing &&
+         (newline = session.inBuffer.find('\n', start)) != std::string::npos) {
+    std::string request = session.inBuffer.substr(start, newline - start);
+    start = newline + 1;
+
+    if (!request.empty() && request.back() == '\r') {
+      request.pop_back();
+    }
+
+    if (request == "!STATS") {
+      session.outBuffer += stats.summary(activeSessions);
+    } else if (request == "!RESET") {
+      session.cursor = startCursor;
+      session.outBuffer += "OK";
+    } else if (request == "!QUIT") {
+      session.closing = true;
+    } else {
+      key.encryptText(session.cursor, request);
+      session.outBuffer += request;
+      session.pending.push_back(received);
+      stats.letters += request.length();
+    }
+    session.outBuffer += '\n';
+  }
+
+  if (session.closing) {
+    session.inBuffer.clear();
+    return;
+  }
+  session.inBuffer.erase(0, start);
+
+  if (session.inBuffer.length() > MAX_LINE_LENGTH) {
+    session.closing = true;
+  }
+}
+
+bool flushSession(int epollFd, Session &session, DaemonStats &stats) {
+  while (!session.outBuffer.empty()) {
+    ssize_t written = send(session.fd, session.outBuffer.data(),
+                           session.outBuffer.length(), MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        watchWrites(epollFd, session, true);
+        return true;
+      } else if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    session.outBuffer.erase(0, written);
+  }
+
+  auto now = LatencyHistogram::Clock::now();
+  for (const auto &received : session.pending) {
+    stats.latency.record(now - received);
+  }
+  stats.requests += session.pending.size();
+  session.pending.clear();
+
+  watchWrites(epollFd, session, false);
+  return !session.closing;
+}
+
+int removeStaleSocket(const std::string &socketPath,
+                      const sockaddr_un &address) {
+  struct stat status = {};
+  if (lstat(socketPath.c_str(), &status) == -1) {
+    if (errno == ENOENT) {
+      return 0;
+    }
+    perror(socketPath.c_str());
+    return 1;
+  }
+  if (!S_ISSOCK(status.st_mode)) {
+    fprintf(stderr, "%s exists and is not a socket\n", socketPath.c_str());
+    return 1;
+  }
+
+  int probeFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (probeFd == -1) {
+    perror("socket");
+    return 1;
+  }
+  int connected = connect(probeFd, (const sockaddr *)&address, sizeof(address));
+  close(probeFd);
+  if (connected == 0) {
+    fprintf(stderr, "Another daemon is listening on %s\n", socketPath.c_str());
+    return 1;
+  }
+
+  if (unlink(socketPath.c_str()) == -1) {
+    perror(socketPath.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
+int runDaemon(const std::string &socketPath) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (socketPath.length() >= sizeof(address.sun_path)) {
+    fprintf(stderr, "Socket path too long: %s\n", socketPath.c_str());
+    return 1;
+  }
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd == -1) {
+    perror("socket");
+    return 1;
+  }
+
+  if (removeStaleSocket(socketPath, address)) {
+    close(listenFd);
+    return 1;
+  }
+  if (bind(listenFd, (sockaddr *)&address, sizeof(address)) == -1) {
+    perror("bind");
+    close(listenFd);
+    return 1;
+  }
+  if (listen(listenFd, SOMAXCONN) == -1) {
+    perror("listen");
+    close(listenFd);
+    return 1;
+  }
+  if (setNonBlocking(listenFd)) {
+    perror("fcntl");
+    close(listenFd);
+    return 1;
+  }
+
+  int epollFd = epoll_create1(0);
+  if (epollFd == -1) {
+    perror("epoll_create1");
+    close(listenFd);
+    return 1;
+  }
+
+  epoll_event listenEvent = {};
+  listenEvent.events = EPOLLIN;
+  listenEvent.data.fd = listenFd;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent);
+
+  struct sigaction action = {};
+  action.sa_handler = requestStop;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  const EnigmaMachine machine = setupEnigmaMachine();
+  const std::shared_ptr<const CompiledKey> key =
+      KeyCache::getShared().get(machine);
+  const KeyCursor startCursor = key->getCursor(machine.getRotorPositions());
+  std::unordered_map<int, Session> sessions;
+  std::vector<int> dirtySessions;
+  std::vector<epoll_event> events(MAX_EVENTS);
+  std::vector<char> readBuffer(READ_CHUNK);
+  DaemonStats stats;
+
+  fprintf(stderr, "Listening on %s\n", socketPath.c_str());
+
+  auto closeSession = [&](int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    sessions.erase(fd);
+  };
+
+  while (!stopRequested) {
+    int ready = epoll_wait(epollFd, events.data(), events.size(), -1);
+    if (ready == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("epoll_wait");
+      break;
+    }
+
+    auto received = LatencyHistogram::Clock::now();
+    dirtySessions.clear();
+
+    for (int i = 0; i < ready; ++i) {
+      int fd = events[i].data.fd;
+
+      if (fd == listenFd) {
+        int clientFd = 0;
+        while ((clientFd = accept(listenFd, nullptr, nullptr)) != -1) {
+          setNonBlocking(clientFd);
+          epoll_event clientEvent = {};
+          clientEvent.events = EPOLLIN | EPOLLRDHUP;
+          clientEvent.data.fd = clientFd;
+          epoll_ctl(epollFd, EPOLL_CTL_ADD, clientFd, &clientEvent);
+          sessions.emplace(clientFd, Session(clientFd, startCursor));
+          stats.connections++;
+        }
+        continue;
+      }
+
+      auto it = sessions.find(fd);
+      if (it == sessions.end()) {
+        continue;
+      }
+      Session &session = it->second;
+
+      if (events[i].events & EPOLLOUT) {
+        dirtySessions.push_back(fd);
+      }
+
+      if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        bool hungUp = false;
+        ssize_t length = 0;
+        while ((length = read(fd, readBuffer.data(), readBuffer.size())) > 0) {
+          session.inBuffer.append(readBuffer.data(), length);
+        }
+        if (length == 0 || (length < 0 && errno != EAGAIN &&
+                            errno != EWOULDBLOCK && errno != EINTR)) {
+          hungUp = true;
+        }
+
+        processRequests(session, *key, startCursor, stats, sessions.size(),
+                        received);
+        stats.batches++;
+        if (hungUp) {
+          session.closing = true;
+        }
+        dirtySessions.push_back(fd);
+      }
+    }
+
+    for (const int fd : dirtySessions) {
+      auto it = sessions.find(fd);
+      if (it == sessions.end()) {
+        continue;
+      }
+      if (!flushSession(epollFd, it->second, stats)) {
+        closeSession(fd);
+      }
+    }
+  }
+
+  for (auto &[fd, session] : sessions) {
+    close(fd);
+  }
+  close(epollFd);
+  close(listenFd);
+  unlink(socketPath.c_str());
+
+  fprintf(stderr, "%s\n", stats.summary(0).c_str());
+  return 0;
+}
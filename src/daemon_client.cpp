@@ -0,0 +1,155 @@
+#include "../include/Daemon.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int connectDaemon(const std::string &socketPath) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1) {
+    return -1;
+  }
+  if (connect(fd, (sockaddr *)&address, sizeof(address)) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool sendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.length()) {
+    ssize_t written =
+        send(fd, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+    if (written <= 0) {
+      return false;
+    }
+    sent += written;
+  }
+  return true;
+}
+
+bool readLines(int fd, std::string &buffer, unsigned int lines) {
+  char chunk[16 * 1024];
+  unsigned int seen = 0;
+  size_t consumed = 0;
+  while (true) {
+    size_t newline = 0;
+    while (seen < lines &&
+           (newline = buffer.find('\n', consumed)) != std::string::npos) {
+      consumed = newline + 1;
+      seen++;
+    }
+    if (seen == lines) {
+      buffer.erase(0, consumed);
+      return true;
+    }
+
+    ssize_t length = read(fd, chunk, sizeof(chunk));
+    if (length <= 0) {
+      return false;
+    }
+    buffer.append(chunk, length);
+  }
+}
+
+} // namespace
+
+int runClient(const std::string &socketPath, unsigned int connections,
+              unsigned int requests, unsigned int messageLength,
+              unsigned int pipelineDepth) {
+  if (pipelineDepth == 0) {
+    pipelineDepth = 1;
+  }
+
+  std::mutex resultMutex;
+  LatencyHistogram latency;
+  unsigned long long completed = 0;
+  unsigned int failures = 0;
+
+  auto worker = [&](unsigned int seed) {
+    LatencyHistogram localLatency;
+    unsigned long long localCompleted = 0;
+
+    int fd = connectDaemon(socketPath);
+    if (fd == -1) {
+      std::lock_guard<std::mutex> lock(resultMutex);
+      failures++;
+      return;
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::string message(messageLength, 'A');
+    std::string batch;
+    std::string responses;
+
+    unsigned int remaining = requests;
+    while (remaining > 0) {
+      unsigned int depth = std::min(remaining, pipelineDepth);
+      batch.clear();
+      for (unsigned int i = 0; i < depth; ++i) {
+        for (auto &symbol : message) {
+          symbol = letter(generator);
+        }
+        batch += message;
+        batch += '\n';
+      }
+
+      auto start = LatencyHistogram::Clock::now();
+      if (!sendAll(fd, batch) || !readLines(fd, responses, depth)) {
+        break;
+      }
+      auto elapsed = LatencyHistogram::Clock::now() - start;
+      for (unsigned int i = 0; i < depth; ++i) {
+        localLatency.record(elapsed);
+      }
+
+      localCompleted += depth;
+      remaining -= depth;
+    }
+    close(fd);
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    latency.merge(localLatency);
+    completed += localCompleted;
+    if (remaining > 0) {
+      failures++;
+    }
+  };
+
+  auto start = LatencyHistogram::Clock::now();
+  std::vector<std::thread> workers;
+  workers.reserve(connections);
+  for (unsigned int i = 0; i < connections; ++i) {
+    workers.emplace_back(worker, i + 1);
+  }
+  for (auto &thread : workers) {
+    thread.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(LatencyHistogram::Clock::now() - start)
+          .count();
+
+  printf("connections=%u completed=%llu failed_connections=%u seconds=%.3f\n",
+         connections, completed, failures, seconds);
+  printf("requests/s=%.0f letters/s=%.0f\n", completed / seconds,
+         completed * messageLength / seconds);
+  printf("%s\n", latency.summary().c_str());
+
+  return failures == 0 ? 0 : 1;
+}
@@ -1,16 +1,16 @@
 #include "../include/Display.hpp"
-#include <cmath>
+#include "../include/SessionRecorder.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
-#include <mutex>
 #include <ncurses.h>
-#include <set>
 #include <string>
-#include <thread>
-#include <utility>
 #include <vector>
 
 int setupWindows(WINDOW *windowMain, Subwindows &subwindows) {
-  initscr();
+  if (!stdscr) {
+    initscr();
+  }
   cbreak();
   noecho();
   keypad(stdscr, TRUE);
@@ -32,17 +32,22 @@ int setupWindows(WINDOW *windowMain, Subwindows &subwindows) {
 
   windowMain = newwin(terminalHeight, terminalWidth, 0, 0);
 
-  unsigned int subwindowHeight = terminalHeight / subwindows.MAX_SUBWINDOWS;
+  unsigned int subwindowHeight = terminalHeight / subwindows.MAX_ROWS;
   std::vector<unsigned int> subwindowYPositions;
-  subwindowYPositions.reserve(4);
-  for (unsigned int i = 0; i < subwindows.MAX_SUBWINDOWS; ++i) {
+  subwindowYPositions.reserve(subwindows.MAX_ROWS);
+  for (unsigned int i = 0; i < subwindows.MAX_ROWS; ++i) {
     subwindowYPositions.push_back(subwindowHeight * i);
   }
 
+  unsigned int outputWidth = (terminalWidth * 2) / 3;
+
   subwindows.rotors = subwin(windowMain, subwindowHeight, terminalWidth,
                              subwindowYPositions[0], 0);
-  subwindows.output = subwin(windowMain, subwindowHeight, terminalWidth,
+  subwindows.output = subwin(windowMain, subwindowHeight, outputWidth,
                              subwindowYPositions[1], 0);
+  subwindows.statistics =
+      subwin(windowMain, subwindowHeight, terminalWidth - outputWidth,
+             subwindowYPositions[1], outputWidth);
   subwindows.keyboard = subwin(windowMain, subwindowHeight, terminalWidth,
                                subwindowYPositions[2], 0);
   subwindows.plugBoard = subwin(windowMain, subwindowHeight, terminalWidth,
@@ -53,42 +58,45 @@ int setupWindows(WINDOW *windowMain, Subwindows &subwindows) {
   return 0;
 }
 
-void refreshWindows(WINDOW *windowMain, Subwindows &subwindows) {
-  wrefresh(windowMain);
-  wrefresh(subwindows.rotors);
-  wrefresh(subwindows.output);
-  wrefresh(subwindows.keyboard);
-  wrefresh(subwindows.plugBoard);
+void refreshWindows(Canvas &windowMain, SubwindowCanvases &subwindows) {
+  windowMain.refresh();
+  subwindows.rotors->refresh();
+  subwindows.output->refresh();
+  subwindows.statistics->refresh();
+  subwindows.keyboard->refresh();
+  subwindows.plugBoard->refresh();
 }
 
-void clearWindows(WINDOW *windowMain, Subwindows &subwindows) {
-  wclear(windowMain);
-  wclear(subwindows.rotors);
-  wclear(subwindows.output);
-  wclear(subwindows.keyboard);
-  wclear(subwindows.plugBoard);
+void clearWindows(Canvas &windowMain, SubwindowCanvases &subwindows) {
+  windowMain.clear();
+  subwindows.rotors->clear();
+  subwindows.output->clear();
+  subwindows.statistics->clear();
+  subwindows.keyboard->clear();
+  subwindows.plugBoard->clear();
 }
 
-void drawSubwindowBoxes(Subwindows &subwindows) {
-  box(subwindows.rotors, '|', '-');
-  box(subwindows.output, '|', '-');
-  box(subwindows.keyboard, '|', '-');
-  box(subwindows.plugBoard, '|', '-');
+void drawSubwindowBoxes(SubwindowCanvases &subwindows) {
+  subwindows.rotors->drawBox();
+  subwindows.output->drawBox();
+  subwindows.statistics->drawBox();
+  subwindows.keyboard->drawBox();
+  subwindows.plugBoard->drawBox();
 }
 
-void highlightSubwindow(WINDOW *subwindow) {
-  wattron(subwindow, A_BOLD);
-  box(subwindow, '|', '-');
-  wattroff(subwindow, A_BOLD);
+void highlightSubwindow(Canvas &subwindow) {
+  subwindow.addStyle(Canvas::BOLD);
+  subwindow.drawBox();
+  subwindow.removeStyle(Canvas::BOLD);
 }
 
-bool escapeMenu(WINDOW *windowOutput, EnigmaMachine &enigmaMachine,
-                const int ESC_KEY, const int ENTER_KEY) {
-  wclear(windowOutput);
+EscapeAction escapeMenu(Canvas &windowOutput, EnigmaMachine &enigmaMachine,
+                        const int ESC_KEY, const int ENTER_KEY) {
+  windowOutput.clear();
   highlightSubwindow(windowOutput);
 
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowOutput, windowHeight, windowWidth);
+  unsigned int windowHeight = windowOutput.getHeight();
+  unsigned int windowWidth = windowOutput.getWidth();
 
   std::array<std::string, 3> selections = {"Resume", "Reset", "Exit"};
   unsigned int yStep = windowHeight / selections.size();
@@ -103,7 +111,7 @@ bool escapeMenu(WINDOW *windowOutput, EnigmaMachine &enigmaMachine,
 
   int keyPress = 0;
   unsigned int selection = 0;
-  bool reset = false;
+  EscapeAction action = ESCAPE_RESUME;
   do {
     switch (keyPress) {
     case KEY_UP:
@@ -122,12 +130,12 @@ bool escapeMenu(WINDOW *windowOutput, EnigmaMachine &enigmaMachine,
         break;
       } else if (selection == 1) {
         enigmaMachine = setupEnigmaMachine();
-        reset = true;
+        action = ESCAPE_RESET;
       } else if (selection == 2) {
-        endwin();
-        exit(0);
+        action = ESCAPE_EXIT;
+        break;
       }
-    } else if (keyPress == ESC_KEY) {
+    } else if (keyPress == ESC_KEY || keyPress == ERR) {
       break;
     } else if (keyPress == KEY_RESIZE) {
       break;
@@ -135,27 +143,28 @@ bool escapeMenu(WINDOW *windowOutput, EnigmaMachine &enigmaMachine,
 
     for (size_t i = 0; i < selections.size(); ++i) {
       if (selection == i) {
-        wattron(windowOutput, COLOR_PAIR(1));
+        windowOutput.addStyle(Canvas::SELECTED);
       } else {
-        wattrset(windowOutput, A_NORMAL);
+        windowOutput.setStyle(Canvas::NORMAL);
       }
-      mvwprintw(windowOutput, yStep + i, xStep - (longestSelectionName / 2),
-                "%s", selections[i].c_str());
+      windowOutput.print(yStep + i, xStep - (longestSelectionName / 2), "%s",
+                         selections[i].c_str());
     }
 
-    wrefresh(windowOutput);
-  } while ((keyPress = getch()));
-  wattrset(windowOutput, A_NORMAL);
-  return reset;
+    windowOutput.refresh();
+    markFrame();
+  } while ((keyPress = readKey()));
+  windowOutput.setStyle(Canvas::NORMAL);
+  return action;
 }
 
-void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
+void rotorConfigMenu(Canvas &windowRotors, EnigmaMachine &enigmaMachine,
                      const int ESC_KEY, const int ENTER_KEY) {
-  wclear(windowRotors);
+  windowRotors.clear();
   highlightSubwindow(windowRotors);
 
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowRotors, windowHeight, windowWidth);
+  unsigned int windowHeight = windowRotors.getHeight();
+  unsigned int windowWidth = windowRotors.getWidth();
 
   struct Button {
     Button(unsigned int index, unsigned int y, unsigned int x)
@@ -169,8 +178,8 @@ void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
   std::vector<Button> buttons;
   buttons.reserve(enigmaMachine.MAX_ROTORS_);
 
-  std::vector<Rotor> allRotors = enigmaMachine.getAvaliableRotors();
-  std::vector<Rotor> activeRotors = enigmaMachine.getActiveRotors();
+  std::span<const Rotor> allRotors = enigmaMachine.getAvaliableRotors();
+  auto activeRotors = enigmaMachine.getActiveRotors();
 
   unsigned int longestModelName = 0;
   for (const auto &rotor : allRotors) {
@@ -210,7 +219,6 @@ void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
     case KEY_RIGHT:
       if (symbolSelection) {
         enigmaMachine.setSymbol(activeRotors[buttonPtr->index], -1);
-        activeRotors = enigmaMachine.getActiveRotors();
         symbolSelectionDirection = true;
       } else if (buttonPtr->index < enigmaMachine.MAX_ROTORS_ - 1) {
         unsigned int buttonRow = buttonPtr->row;
@@ -233,7 +241,6 @@ void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
     case KEY_LEFT:
       if (symbolSelection) {
         enigmaMachine.setSymbol(activeRotors[buttonPtr->index], 1);
-        activeRotors = enigmaMachine.getActiveRotors();
         symbolSelectionDirection = false;
       } else if (buttonPtr->index > 0) {
         unsigned int buttonRow = buttonPtr->row;
@@ -249,57 +256,57 @@ void rotorConfigMenu(WINDOW *windowRotors, EnigmaMachine &enigmaMachine,
     if (keyPress == ENTER_KEY && (!symbolSelection)) {
       enigmaMachine.setRotor(allRotors[buttonPtr->row],
                              activeRotors[buttonPtr->index], buttonPtr->index);
-      activeRotors = enigmaMachine.getActiveRotors();
     } else if (keyPress == KEY_RESIZE) {
       break;
     }
 
     for (size_t i = 0; i < enigmaMachine.MAX_ROTORS_; ++i) {
-      wattron(windowRotors, A_BOLD);
-      mvwprintw(windowRotors, buttons[i].y, buttons[i].x, "Slot: %zu", i + 1);
-      wattroff(windowRotors, A_BOLD);
+      windowRotors.addStyle(Canvas::BOLD);
+      windowRotors.print(buttons[i].y, buttons[i].x, "Slot: %zu", i + 1);
+      windowRotors.removeStyle(Canvas::BOLD);
 
       unsigned int j = 0;
       for (; j < allRotors.size(); ++j) {
         if (buttons[i].isSelected && buttons[i].row == j) {
-          wattron(windowRotors, COLOR_PAIR(1));
+          windowRotors.addStyle(Canvas::SELECTED);
         } else if (activeRotors[i].getModelName() ==
                    allRotors[j].getModelName()) {
-          wattron(windowRotors, COLOR_PAIR(2));
+          windowRotors.addStyle(Canvas::ACTIVE);
         } else {
-          wattroff(windowRotors, COLOR_PAIR(1));
+          windowRotors.removeStyle(Canvas::SELECTED);
         }
-        mvwprintw(windowRotors, buttons[i].y + j + 1, buttons[i].x, "%s",
-                  allRotors[j].getModelName().c_str());
-        wattrset(windowRotors, A_NORMAL);
+        windowRotors.print(buttons[i].y + j + 1, buttons[i].x, "%s",
+                           allRotors[j].getModelName().c_str());
+        windowRotors.setStyle(Canvas::NORMAL);
       }
 
       unsigned int xStep = longestModelName / 2;
       if (!symbolSelectionDirection && buttons[i].row == j) {
-        wattron(windowRotors, COLOR_PAIR(1));
+        windowRotors.addStyle(Canvas::SELECTED);
       }
-      mvwprintw(windowRotors, buttons[i].y + j + 1, buttons[i].x, "<");
-      wattrset(windowRotors, A_NORMAL);
-      mvwprintw(windowRotors, buttons[i].y + j + 1, buttons[i].x + xStep, "%c",
-                activeRotors[i].getActiveSymbol());
+      windowRotors.print(buttons[i].y + j + 1, buttons[i].x, "<");
+      windowRotors.setStyle(Canvas::NORMAL);
+      windowRotors.print(buttons[i].y + j + 1, buttons[i].x + xStep, "%c",
+                         activeRotors[i].getActiveSymbol());
       xStep += xStep;
       if (symbolSelectionDirection && buttons[i].row == j) {
-        wattron(windowRotors, COLOR_PAIR(1));
+        windowRotors.addStyle(Canvas::SELECTED);
       }
-      mvwprintw(windowRotors, buttons[i].y + j + 1, buttons[i].x + xStep, ">");
-      wattrset(windowRotors, A_NORMAL);
+      windowRotors.print(buttons[i].y + j + 1, buttons[i].x + xStep, ">");
+      windowRotors.setStyle(Canvas::NORMAL);
     }
-    wrefresh(windowRotors);
-  } while ((keyPress = getch()) != ESC_KEY);
+    windowRotors.refresh();
+    markFrame();
+  } while ((keyPress = readKey()) != ESC_KEY && keyPress != ERR);
 }
 
-void plugBoardConfigMenu(WINDOW *windowPlugBoard, EnigmaMachine &enigmaMachine,
+void plugBoardConfigMenu(Canvas &windowPlugBoard, EnigmaMachine &enigmaMachine,
                          const int ESC_KEY) {
-  wclear(windowPlugBoard);
+  windowPlugBoard.clear();
   highlightSubwindow(windowPlugBoard);
 
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowPlugBoard, windowHeight, windowWidth);
+  unsigned int windowHeight = windowPlugBoard.getHeight();
+  unsigned int windowWidth = windowPlugBoard.getWidth();
 
   struct Button {
     unsigned int index = 0;
@@ -309,7 +316,7 @@ void plugBoardConfigMenu(WINDOW *windowPlugBoard, EnigmaMachine &enigmaMachine,
     bool arrow = 0;
   };
 
-  std::vector<Cable> allCables = enigmaMachine.getActivePlugs();
+  std::span<const Cable> allCables = enigmaMachine.getActivePlugs();
   std::string cableID = "Plug ";
   unsigned int longestCableName = cableID.length() + 1;
 
@@ -355,16 +362,16 @@ void plugBoardConfigMenu(WINDOW *windowPlugBoard, EnigmaMachine &enigmaMachine,
       break;
     }
 
-    wattron(windowPlugBoard, A_BOLD);
-    mvwprintw(windowPlugBoard, button.y, button.x, "%s",
-              (cableID + std::to_string(button.index + 1) + " ").c_str());
+    windowPlugBoard.addStyle(Canvas::BOLD);
+    windowPlugBoard.print(
+        button.y, button.x, "%s",
+        (cableID + std::to_string(button.index + 1) + " ").c_str());
 
     char plug;
     unsigned int yStep = button.y + 1;
     unsigned int xStep = button.x;
     for (unsigned int i = 0; i < Cable::MAX_PLUGS; ++i) {
-      allCables = enigmaMachine.getActivePlugs();
-      wattrset(windowPlugBoard, A_NORMAL);
+      windowPlugBoard.setStyle(Canvas::NORMAL);
       xStep = button.x;
 
       if (i % 2 == 0) {
@@ -377,42 +384,43 @@ void plugBoardConfigMenu(WINDOW *windowPlugBoard, EnigmaMachine &enigmaMachine,
       }
 
       if (button.row == i) {
-        wattron(windowPlugBoard, COLOR_PAIR(1));
+        windowPlugBoard.addStyle(Canvas::SELECTED);
       }
-      mvwprintw(windowPlugBoard, yStep, xStep, "|");
+      windowPlugBoard.print(yStep, xStep, "|");
       xStep++;
-      mvwprintw(windowPlugBoard, yStep, xStep, "%c", plug);
+      windowPlugBoard.print(yStep, xStep, "%c", plug);
       xStep++;
-      mvwprintw(windowPlugBoard, yStep, xStep, "|");
+      windowPlugBoard.print(yStep, xStep, "|");
       yStep++;
     }
 
-    wattrset(windowPlugBoard, A_NORMAL);
+    windowPlugBoard.setStyle(Canvas::NORMAL);
     if (button.row == button.rowsHeight && button.arrow == 0) {
-      wattron(windowPlugBoard, COLOR_PAIR(1));
-      mvwprintw(windowPlugBoard, yStep, xStep, "<");
-      wattroff(windowPlugBoard, COLOR_PAIR(1));
+      windowPlugBoard.addStyle(Canvas::SELECTED);
+      windowPlugBoard.print(yStep, xStep, "<");
+      windowPlugBoard.removeStyle(Canvas::SELECTED);
       xStep += (longestCableName - 1);
-      mvwprintw(windowPlugBoard, yStep, xStep, ">");
+      windowPlugBoard.print(yStep, xStep, ">");
     } else if (button.row == button.rowsHeight && button.arrow == 1) {
-      mvwprintw(windowPlugBoard, yStep, xStep, "<");
+      windowPlugBoard.print(yStep, xStep, "<");
       xStep += (longestCableName - 1);
-      wattron(windowPlugBoard, COLOR_PAIR(1));
-      mvwprintw(windowPlugBoard, yStep, xStep, ">");
-      wattroff(windowPlugBoard, COLOR_PAIR(1));
+      windowPlugBoard.addStyle(Canvas::SELECTED);
+      windowPlugBoard.print(yStep, xStep, ">");
+      windowPlugBoard.removeStyle(Canvas::SELECTED);
     } else {
-      mvwprintw(windowPlugBoard, yStep, xStep, "<");
+      windowPlugBoard.print(yStep, xStep, "<");
       xStep += (longestCableName - 1);
-      mvwprintw(windowPlugBoard, yStep, xStep, ">");
+      windowPlugBoard.print(yStep, xStep, ">");
     }
 
-    wrefresh(windowPlugBoard);
-  } while ((keyPress = getch()) != ESC_KEY);
+    windowPlugBoard.refresh();
+    markFrame();
+  } while ((keyPress = readKey()) != ESC_KEY && keyPress != ERR);
 }
 
-void drawKeyboard(WINDOW *windowKeyboard, const int keyPress) {
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowKeyboard, windowHeight, windowWidth);
+void drawKeyboard(Canvas &windowKeyboard, const int keyPress) {
+  unsigned int windowHeight = windowKeyboard.getHeight();
+  unsigned int windowWidth = windowKeyboard.getWidth();
 
   struct Keyboard {
     const unsigned int MAX_ROWS = 3;
@@ -425,7 +433,6 @@ void drawKeyboard(WINDOW *windowKeyboard, const int keyPress) {
   };
 
   Keyboard keyboard;
-  std::pair<char, std::pair<int, int>> activeKey{0, {0, 0}};
 
   unsigned int yStep = windowHeight / keyboard.MAX_ROWS;
   int xStep = 0;
@@ -434,18 +441,16 @@ void drawKeyboard(WINDOW *windowKeyboard, const int keyPress) {
     xStep = windowWidth / 2 - row.size();
     for (const auto key : row) {
       if (key == keyPress) {
-        wattron(windowKeyboard, A_DIM);
-        mvwprintw(windowKeyboard, yStep, xStep, "%c", key);
-        wattroff(windowKeyboard, A_DIM);
+        windowKeyboard.addStyle(Canvas::DIM);
+        windowKeyboard.print(yStep, xStep, "%c", key);
+        windowKeyboard.removeStyle(Canvas::DIM);
         xStep++;
-        mvwprintw(windowKeyboard, yStep, xStep, " ");
+        windowKeyboard.print(yStep, xStep, " ");
         xStep++;
-
-        activeKey = std::make_pair(key, std::make_pair(yStep, xStep - 2));
       } else {
-        mvwprintw(windowKeyboard, yStep, xStep, "%c", key);
+        windowKeyboard.print(yStep, xStep, "%c", key);
         xStep++;
-        mvwprintw(windowKeyboard, yStep, xStep, " ");
+        windowKeyboard.print(yStep, xStep, " ");
         xStep++;
       }
     }
@@ -455,48 +460,15 @@ void drawKeyboard(WINDOW *windowKeyboard, const int keyPress) {
   draw(keyboard.topRow);
   draw(keyboard.middleRow);
   draw(keyboard.bottomRow);
-
-  std::thread keyPressWorker(removeKeyPress, windowKeyboard, activeKey);
-  keyPressWorker.detach();
 }
 
-void removeKeyPress(
-    WINDOW *windowKeyboard,
-    const std::pair<char, std::pair<unsigned int, unsigned int>> activeKey) {
-  static std::mutex activeKeyMutex;
-  static std::set<char> activeKeys;
-
-  char key = activeKey.first;
-
-  {
-    std::lock_guard<std::mutex> activeKeyLock(activeKeyMutex);
-    if (activeKeys.count(key)) {
-      return;
-    }
-    activeKeys.insert(key);
-  }
-
-  std::this_thread::sleep_for(std::chrono::seconds(1));
-
-  {
-    unsigned int yCoord = activeKey.second.first;
-    unsigned int xCoord = activeKey.second.second;
-
-    std::lock_guard<std::mutex> lock(activeKeyMutex);
-    mvwprintw(windowKeyboard, yCoord, xCoord, "%c", key);
-    activeKeys.erase(key);
-  }
-
-  wrefresh(windowKeyboard);
-}
-
-void drawRotors(WINDOW *windowRotors, const EnigmaMachine &enigmaMachine) {
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowRotors, windowHeight, windowWidth);
+void drawRotors(Canvas &windowRotors, const EnigmaMachine &enigmaMachine) {
+  unsigned int windowHeight = windowRotors.getHeight();
+  unsigned int windowWidth = windowRotors.getWidth();
 
   const unsigned int MAX_SYMBOLS_COLUMN = 3;
 
-  std::vector<Rotor> activeRotors = enigmaMachine.getActiveRotors();
+  auto activeRotors = enigmaMachine.getActiveRotors();
 
   unsigned int yStep = windowHeight / MAX_SYMBOLS_COLUMN;
 
@@ -504,32 +476,32 @@ void drawRotors(WINDOW *windowRotors, const EnigmaMachine &enigmaMachine) {
     unsigned int xStep = (windowWidth / 2) - EnigmaMachine::MAX_ROTORS_ * 2;
 
     if (i == MAX_SYMBOLS_COLUMN / 2) {
-      wattron(windowRotors, A_BOLD);
+      windowRotors.addStyle(Canvas::BOLD);
     } else {
-      wattroff(windowRotors, A_BOLD);
+      windowRotors.removeStyle(Canvas::BOLD);
     }
 
     for (unsigned int j = 0; j < EnigmaMachine::MAX_ROTORS_; ++j) {
-      mvwprintw(windowRotors, yStep, xStep, "|");
+      windowRotors.print(yStep, xStep, "|");
       xStep++;
-      mvwprintw(windowRotors, yStep, xStep, "%c",
-                activeRotors[j].getActiveSymbol(i - 1));
+      windowRotors.print(yStep, xStep, "%c",
+                         activeRotors[j].getActiveSymbol(i - 1));
       xStep++;
-      mvwprintw(windowRotors, yStep, xStep, "|");
+      windowRotors.print(yStep, xStep, "|");
       xStep++;
-      mvwprintw(windowRotors, yStep, xStep, " ");
+      windowRotors.print(yStep, xStep, " ");
       xStep++;
     }
     yStep++;
   }
 }
 
-void drawPlugBoard(WINDOW *windowPlugBoard,
+void drawPlugBoard(Canvas &windowPlugBoard,
                    const EnigmaMachine &enigmaMachine) {
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowPlugBoard, windowHeight, windowWidth);
+  unsigned int windowHeight = windowPlugBoard.getHeight();
+  unsigned int windowWidth = windowPlugBoard.getWidth();
 
-  std::vector<Cable> activePlugs = enigmaMachine.getActivePlugs();
+  std::span<const Cable> activePlugs = enigmaMachine.getActivePlugs();
   const unsigned int PLUG_WIDTH = 4;
 
   char plug;
@@ -546,70 +518,113 @@ void drawPlugBoard(WINDOW *windowPlugBoard,
       } else {
         plug = activePlugs[j].input_;
       }
-      mvwprintw(windowPlugBoard, yStep, xStep, "|");
+      windowPlugBoard.print(yStep, xStep, "|");
       xStep++;
-      mvwprintw(windowPlugBoard, yStep, xStep, "%c", plug);
+      windowPlugBoard.print(yStep, xStep, "%c", plug);
       xStep++;
-      mvwprintw(windowPlugBoard, yStep, xStep, "|");
+      windowPlugBoard.print(yStep, xStep, "|");
       xStep++;
-      mvwprintw(windowPlugBoard, yStep, xStep, " ");
+      windowPlugBoard.print(yStep, xStep, " ");
       xStep++;
     }
     yStep++;
   }
 }
 
-bool drawOutput(WINDOW *windowOutput, const int inputKey, const bool reset) {
-  unsigned int windowHeight, windowWidth = 0;
-  getmaxyx(windowOutput, windowHeight, windowWidth);
+unsigned int getOutputCapacity(const Canvas &windowOutput) {
+  unsigned int windowHeight = windowOutput.getHeight();
+  unsigned int windowWidth = windowOutput.getWidth();
+
+  if (windowHeight <= OUTPUT_Y_PADDING * 2 ||
+      windowWidth <= OUTPUT_X_PADDING * 2) {
+    return 0;
+  }
+  return (windowHeight - (OUTPUT_Y_PADDING * 2)) *
+         (windowWidth - (OUTPUT_X_PADDING * 2));
+}
+
+void drawOutput(Canvas &windowOutput, const std::string &text) {
+  unsigned int windowHeight = windowOutput.getHeight();
+  unsigned int windowWidth = windowOutput.getWidth();
 
-  const unsigned int Y_PADDING = 2, X_PADDING = 4;
-  const unsigned int MAX_HEIGHT_CHARACTERS = windowHeight - (Y_PADDING * 2);
-  const unsigned int MAX_WIDTH_CHARACTERS = windowWidth - (X_PADDING * 2);
+  const unsigned int MAX_HEIGHT_CHARACTERS =
+      windowHeight - (OUTPUT_Y_PADDING * 2);
+  const unsigned int MAX_WIDTH_CHARACTERS =
+      windowWidth - (OUTPUT_X_PADDING * 2);
 
-  static std::string displayedText;
-  if (reset) {
-    displayedText = "";
+  windowOutput.erase();
+  if (windowHeight <= OUTPUT_Y_PADDING * 2 ||
+      windowWidth <= OUTPUT_X_PADDING * 2) {
+    return;
   }
-  bool spinRotor = true;
-  std::vector<std::string> substrings = {};
-  unsigned int lines = (unsigned int)std::ceil((float)displayedText.length() /
-                                               MAX_WIDTH_CHARACTERS);
-
-  if (inputKey == KEY_BACKSPACE) {
-    wclear(windowOutput);
-    if (displayedText.length() > 0) {
-      if (displayedText.back() == ' ') {
-        spinRotor = false;
-      }
-      displayedText.pop_back();
-    } else {
-      spinRotor = false;
-      return spinRotor;
-    }
-  } else if (inputKey != 0) {
-    if (lines > MAX_HEIGHT_CHARACTERS) {
-      spinRotor = false;
-      return spinRotor;
-    }
-    displayedText += inputKey;
+
+  unsigned int line = 0;
+  for (size_t start = 0;
+       start < text.length() && line < MAX_HEIGHT_CHARACTERS;
+       start += MAX_WIDTH_CHARACTERS) {
+    windowOutput.print(OUTPUT_Y_PADDING + line, OUTPUT_X_PADDING, "%.*s",
+                       (int)MAX_WIDTH_CHARACTERS, text.c_str() + start);
+    line++;
   }
+}
+
+void drawStatistics(Canvas &windowStatistics,
+                    const TextStatistics &statistics,
+                    const KeyCacheStats &keyCache) {
+  unsigned int windowHeight = windowStatistics.getHeight();
+  unsigned int windowWidth = windowStatistics.getWidth();
+
+  const unsigned int X_PADDING = 2;
+  const unsigned int MAX_TOP_ENTRIES = 8;
 
-  if (displayedText.length() > MAX_WIDTH_CHARACTERS) {
-    unsigned int start = 0;
-    for (unsigned int i = 0; i < lines; ++i) {
-      std::string substring = displayedText.substr(start, MAX_WIDTH_CHARACTERS);
-      start += MAX_WIDTH_CHARACTERS;
-      substrings.push_back(substring);
+  windowStatistics.erase();
+  if (windowHeight < 3 || windowWidth <= X_PADDING * 2) {
+    return;
+  }
+  const int MAX_WIDTH_CHARACTERS = windowWidth - (X_PADDING * 2);
+
+  std::vector<std::pair<char, uint64_t>> letters;
+  for (char letter = 'A'; letter <= 'Z'; ++letter) {
+    if (statistics.getFrequency(letter) > 0) {
+      letters.emplace_back(letter, statistics.getFrequency(letter));
     }
-  } else {
-    substrings.push_back(displayedText);
+  }
+  std::sort(letters.begin(), letters.end(), [](const auto &a, const auto &b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+
+  std::string letterLine = "Freq:";
+  for (size_t i = 0; i < letters.size() && i < MAX_TOP_ENTRIES; ++i) {
+    letterLine += " " + std::string(1, letters[i].first) + ":" +
+                  std::to_string(letters[i].second);
   }
 
-  for (size_t i = 0; i < substrings.size(); ++i) {
-    mvwprintw(windowOutput, (Y_PADDING + i), X_PADDING, "%s",
-              substrings[i].c_str());
+  std::string bigramLine = "Bigr:";
+  for (const auto &[bigram, count] :
+       statistics.getTopBigrams(MAX_TOP_ENTRIES)) {
+    bigramLine += " " + bigram + ":" + std::to_string(count);
   }
 
-  return spinRotor;
+  char summaryLine[64];
+  snprintf(summaryLine, sizeof(summaryLine), "Letters: %llu  IC: %.4f",
+           (unsigned long long)statistics.getLetterCount(),
+           statistics.getIndexOfCoincidence());
+
+  char keyCacheLine[96];
+  snprintf(keyCacheLine, sizeof(keyCacheLine),
+           "Keys: %zu/%zu  hits: %llu  misses: %llu  %zu KiB", keyCache.entries,
+           keyCache.capacity, keyCache.hits, keyCache.misses,
+           keyCache.bytes / 1024);
+
+  std::array<std::string, 4> lines = {summaryLine, letterLine, bigramLine,
+                                      keyCacheLine};
+  unsigned int yStep = 1;
+  for (const auto &line : lines) {
+    if (yStep >= windowHeight - 1) {
+      break;
+    }
+    windowStatistics.print(yStep, X_PADDING, "%.*s", MAX_WIDTH_CHARACTERS,
+                           line.c_str());
+    yStep++;
+  }
 }
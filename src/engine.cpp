@@ -0,0 +1,160 @@
+#include "../include/Engine.hpp"
+
+Engine::Engine(const EnigmaMachine &machine)
+    : state_(machine), key_(KeyCache::getShared().get(machine)),
+      snapshots_(state_) {}
+
+Engine::~Engine() { stop(); }
+
+void Engine::start() {
+  if (worker_.joinable()) {
+    return;
+  }
+  stopRequested_ = false;
+  worker_ = std::thread(&Engine::run, this);
+}
+
+void Engine::stop() {
+  if (!worker_.joinable()) {
+    return;
+  }
+  stopRequested_ = true;
+  submitted_.fetch_add(1, std::memory_order_release);
+  submitted_.notify_one();
+  worker_.join();
+}
+
+bool Engine::submit(char key) {
+  while (!keys_.push(key)) {
+    if (!worker_.joinable()) {
+      flush();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  submitted_.fetch_add(1, std::memory_order_release);
+  submitted_.notify_one();
+  return true;
+}
+
+void Engine::flush() {
+  if (!worker_.joinable() && drain()) {
+    publish();
+  }
+}
+
+void Engine::setOutputCapacity(size_t capacity) {
+  outputCapacity_.store(capacity, std::memory_order_relaxed);
+}
+
+void Engine::pause() {
+  if (!worker_.joinable()) {
+    drain();
+    return;
+  }
+  pauseRequested_.store(true, std::memory_order_release);
+  submitted_.fetch_add(1, std::memory_order_release);
+  submitted_.notify_one();
+  while (!parked_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+void Engine::resume() {
+  key_ = KeyCache::getShared().get(state_.machine);
+  publish();
+  pauseRequested_.store(false, std::memory_order_release);
+  pauseRequested_.notify_one();
+  while (worker_.joinable() && parked_.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+}
+
+EnigmaMachine &Engine::getMachine() { return state_.machine; }
+
+void Engine::resetOutput() {
+  state_.outputText.clear();
+  state_.statistics.clear();
+}
+
+bool Engine::updateSnapshot() { return snapshots_.update(); }
+
+const EngineSnapshot &Engine::getSnapshot() const {
+  return snapshots_.getFront();
+}
+
+void Engine::run() {
+  while (!stopRequested_.load(std::memory_order_acquire)) {
+    unsigned long long seen = submitted_.load(std::memory_order_acquire);
+
+    if (drain()) {
+      publish();
+    }
+
+    if (pauseRequested_.load(std::memory_order_acquire) && keys_.empty()) {
+      parked_.store(true, std::memory_order_release);
+      while (pauseRequested_.load(std::memory_order_acquire)) {
+        pauseRequested_.wait(true, std::memory_order_acquire);
+      }
+      parked_.store(false, std::memory_order_release);
+      continue;
+    }
+
+    if (keys_.empty()) {
+      submitted_.wait(seen, std::memory_order_acquire);
+    }
+  }
+}
+
+bool Engine::drain() {
+  bool changed = false;
+  char key = '\0';
+  while (keys_.pop(key)) {
+    process(key);
+    changed = true;
+  }
+  return changed;
+}
+
+void Engine::process(char key) {
+  std::string &text = state_.outputText;
+
+  if (key == BACKSPACE) {
+    if (text.empty()) {
+      return;
+    }
+    if (text.back() != ' ') {
+      state_.machine.spinRotors(1);
+    }
+    char letter = text.back();
+    text.pop_back();
+    state_.statistics.remove(text.empty() ? '\0' : text.back(), letter);
+    return;
+  }
+
+  bool hasRoom =
+      text.length() < outputCapacity_.load(std::memory_order_relaxed);
+
+  if (key == ' ') {
+    if (hasRoom) {
+      text += key;
+    }
+    return;
+  }
+
+  state_.lastKey = key;
+  state_.keyPresses++;
+  if (hasRoom) {
+    KeyCursor cursor = key_->getCursor(state_.machine.getRotorPositions());
+    char encryptedLetter = key_->encrypt(cursor, key);
+    state_.statistics.add(text.empty() ? '\0' : text.back(), encryptedLetter);
+    text += encryptedLetter;
+    state_.machine.setRotorPositions(key_->getPositions(cursor));
+  }
+}
+
+void Engine::publish() {
+  state_.keyCache = KeyCache::getShared().getStats();
+  snapshots_.getBack() = state_;
+  snapshots_.publish();
+}
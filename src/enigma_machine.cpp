@@ -1,5 +1,11 @@
 #include "../include/EnigmaMachine.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
 
 EnigmaMachine setupEnigmaMachine() {
   Rotor rotorI = Rotor("Enigma I | Rotor I", "EKMFLGDQVZNTOWYHXUSPAIBRCJ", 'Q');
@@ -30,88 +36,125 @@ EnigmaMachine setupEnigmaMachine() {
   return EnigmaMachine(rotors, reflectors, cables);
 }
 
-Rotor::Rotor(const std::string &modelName, const std::string &symbols,
-             char notch)
-    : modelName_(modelName), notch_(notch) {
-  if (symbols.length() >= symbols_.size()) {
-    for (size_t i = 0; i < symbols_.size(); ++i) {
-      symbols_[i] = symbols[i];
+namespace {
+
+const unsigned int MAX_WIRINGS = 256;
+
+std::array<RotorWiring, MAX_WIRINGS> wirings = [] {
+  std::array<RotorWiring, MAX_WIRINGS> result = {};
+  for (unsigned int i = 0; i < RotorWiring::MAX_SYMBOLS; ++i) {
+    result[0].symbols[i] = 'A' + i;
+    result[0].inverse[i] = i;
+  }
+  return result;
+}();
+std::atomic<unsigned int> wiringCount = 1;
+std::mutex wiringMutex;
+
+} // namespace
+
+uint16_t RotorWiring::add(const std::string &modelName,
+                          const std::string &symbols, char notch) {
+  RotorWiring wiring;
+  wiring.modelName = modelName;
+  wiring.notch = notch;
+  if (symbols.length() >= MAX_SYMBOLS) {
+    for (unsigned int i = 0; i < MAX_SYMBOLS; ++i) {
+      wiring.symbols[i] = symbols[i];
+      if (symbols[i] >= 'A' && symbols[i] <= 'Z') {
+        wiring.inverse[symbols[i] - 'A'] = i;
+      }
+      if (symbols[i] == notch) {
+        wiring.notchPosition = i;
+      }
+    }
+    wiring.forward = Permutation::fromSymbols(wiring.symbols.data());
+    wiring.backward = wiring.forward.inverse();
+  }
+
+  std::lock_guard<std::mutex> lock(wiringMutex);
+
+  unsigned int count = wiringCount.load(std::memory_order_relaxed);
+  for (unsigned int i = 1; i < count; ++i) {
+    if (wirings[i].modelName == wiring.modelName &&
+        wirings[i].symbols == wiring.symbols && wirings[i].notch == notch) {
+      return i;
     }
-    activeSymbol_ = symbols[0];
   }
 
-  for (size_t i = 0; i < MAX_SYMBOLS_; ++i) {
-    alphabet_['A' + i] = i;
+  if (count == MAX_WIRINGS) {
+    fprintf(stderr, "Too many rotor wirings registered\n");
+    abort();
   }
+
+  wirings[count] = wiring;
+  wiringCount.store(count + 1, std::memory_order_release);
+  return count;
 }
 
+const RotorWiring &RotorWiring::get(uint16_t id) { return wirings[id]; }
+
+Rotor::Rotor(const std::string &modelName, const std::string &symbols,
+             char notch)
+    : id_(RotorWiring::add(modelName, symbols, notch)) {}
+
 void Rotor::spin(int direction) {
   if (direction == 1) {
-    if (activeSymbol_ == symbols_.back()) {
-      position_ = 0;
-      activeSymbol_ = symbols_[position_];
-    } else {
-      position_++;
-      activeSymbol_ = symbols_[position_];
-    }
+    position_ = (position_ + 1) % MAX_SYMBOLS_;
   } else if (direction == -1) {
-    if (activeSymbol_ == symbols_.front()) {
-      position_ = symbols_.size() - 1;
-      activeSymbol_ = symbols_[position_];
-    } else {
-      position_--;
-      activeSymbol_ = symbols_[position_];
-    }
+    position_ = (position_ + MAX_SYMBOLS_ - 1) % MAX_SYMBOLS_;
   }
 }
 
-void Rotor::transfer(char &key, int direction) {
-  if (alphabet_.find(key) == alphabet_.end()) {
+void Rotor::transfer(char &key, int direction) const {
+  if (key < 'A' || key > 'Z') {
     return;
   }
 
+  const RotorWiring &wiring = RotorWiring::get(id_);
   if (direction == 1) {
-    size_t position = (alphabet_.at(key) + position_) % symbols_.size();
-    key = symbols_[position];
+    key = wiring.symbols[(key - 'A' + position_) % MAX_SYMBOLS_];
   } else {
-    size_t position =
-        (symbols_.size() +
-         (std::find(symbols_.begin(), symbols_.end(), key) - symbols_.begin()) -
-         position_) %
-        symbols_.size();
-    key = 'A' + position;
+    key = 'A' + (wiring.inverse[key - 'A'] + MAX_SYMBOLS_ - position_) %
+                    MAX_SYMBOLS_;
   }
 }
 
-const std::string &Rotor::getModelName() const { return modelName_; }
+const std::string &Rotor::getModelName() const {
+  return RotorWiring::get(id_).modelName;
+}
 
 char Rotor::getNotch(const int offset) const {
+  const RotorWiring &wiring = RotorWiring::get(id_);
   if (offset == 0) {
-    return notch_;
+    return wiring.notch;
+  } else if (wiring.notchPosition < 0) {
+    return '\0';
   }
+  return wiring.symbols[(wiring.notchPosition + offset) % MAX_SYMBOLS_];
+}
 
-  for (unsigned long int i = 0; i < symbols_.size(); ++i) {
-    if (notch_ == symbols_[i]) {
-      if (symbols_[i] == symbols_.back()) {
-        return symbols_[offset - 1];
-      } else {
-        return symbols_[i + offset];
-      }
-    }
-  }
+char Rotor::getActiveSymbol(const int offset) const {
+  return RotorWiring::get(id_).symbols[(position_ + MAX_SYMBOLS_ + offset) %
+                                       MAX_SYMBOLS_];
+}
+
+unsigned int Rotor::getPosition() const { return position_; }
 
-  return '\0';
+void Rotor::setPosition(unsigned int position) {
+  position_ = position % MAX_SYMBOLS_;
 }
 
-char Rotor::getActiveSymbol(const int offset) const {
-  if (offset < 0 && symbols_[position_] == symbols_.front()) {
-    return symbols_.back() + (offset + 1);
-  } else if (offset > 0 && symbols_[position_] == symbols_.back()) {
-    return symbols_[0 + (offset - 1)];
+Permutation Rotor::getPermutation(int direction) const {
+  const RotorWiring &wiring = RotorWiring::get(id_);
+  if (direction == 1) {
+    return Permutation::shift(position_).then(wiring.forward);
   }
-  return symbols_[position_ + offset];
+  return wiring.backward.then(Permutation::shift(-position_));
 }
 
+uint16_t Rotor::getWiringId() const { return id_; }
+
 Reflector::Reflector(const std::string &modelName, const std::string &symbols)
     : Rotor(modelName, symbols, '\0') {}
 
@@ -133,7 +176,7 @@ EnigmaMachine::EnigmaMachine(std::vector<Rotor> &rotors,
     : avaliableRotors_(rotors), avaliableReflectors_(reflectors),
       activePlugs_(cables) {
   for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
-    activeRotors_.emplace_back(avaliableRotors_[i]);
+    activeRotors_[i] = avaliableRotors_[i];
   }
 }
 
@@ -161,6 +204,12 @@ void EnigmaMachine::setPlug(const int index, const bool input,
   }
 }
 
+void EnigmaMachine::setCable(unsigned int index, char input, char output) {
+  if (index < activePlugs_.size()) {
+    activePlugs_[index] = Cable(input, output);
+  }
+}
+
 void EnigmaMachine::encrypt(char &key) {
   for (auto &cable : activePlugs_) {
     cable.transfer(key);
@@ -181,6 +230,21 @@ void EnigmaMachine::encrypt(char &key) {
   }
 }
 
+void EnigmaMachine::encryptText(std::string &text) {
+  encryptText(text.data(), text.length());
+}
+
+void EnigmaMachine::encryptText(char *text, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (!isalpha((unsigned char)text[i])) {
+      continue;
+    }
+    text[i] = toupper((unsigned char)text[i]);
+    encrypt(text[i]);
+    spinRotors(-1);
+  }
+}
+
 void EnigmaMachine::spinRotors(int direction) {
   activeRotors_.back().spin(direction);
 
@@ -226,6 +290,168 @@ void EnigmaMachine::setRotor(const Rotor &inputRotor,
   activeRotors_[index] = inputRotor;
 }
 
+void EnigmaMachine::setRotorOrder(
+    const std::array<unsigned int, MAX_ROTORS_> &order) {
+  for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
+    activeRotors_[i] = avaliableRotors_[order[i] % avaliableRotors_.size()];
+  }
+}
+
+void EnigmaMachine::setRotorPositions(
+    const std::array<unsigned int, MAX_ROTORS_> &positions) {
+  for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
+    activeRotors_[i].setPosition(positions[i]);
+  }
+}
+
+int EnigmaMachine::setKey(const std::string &key) {
+  std::array<unsigned int, MAX_ROTORS_> order = {};
+  std::array<unsigned int, MAX_ROTORS_> positions = {};
+  size_t start = 0;
+  for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
+    size_t open = key.find('[', start);
+    if (open == std::string::npos || open + 2 >= key.length() ||
+        key[open + 2] != ']') {
+      fprintf(stderr, "Expected three rotors as Model[Symbol]\n");
+      return 1;
+    }
+    size_t first = key.find_first_not_of(' ', start);
+    size_t last = key.find_last_not_of(' ', open - 1);
+    std::string modelName =
+        first < open ? key.substr(first, last - first + 1) : "";
+    start = open + 3;
+
+    auto rotor = std::find_if(
+        avaliableRotors_.begin(), avaliableRotors_.end(),
+        [&](const Rotor &candidate) {
+          return candidate.getModelName() == modelName;
+        });
+    if (rotor == avaliableRotors_.end()) {
+      fprintf(stderr, "Unknown rotor '%s'\n", modelName.c_str());
+      return 1;
+    }
+    order[i] = rotor - avaliableRotors_.begin();
+    if (std::find(order.begin(), order.begin() + i, order[i]) !=
+        order.begin() + i) {
+      fprintf(stderr, "Rotor '%s' is used twice\n", modelName.c_str());
+      return 1;
+    }
+
+    char symbol = toupper((unsigned char)key[open + 1]);
+    Rotor window = *rotor;
+    for (positions[i] = 0; positions[i] < RotorWiring::MAX_SYMBOLS;
+         ++positions[i]) {
+      window.setPosition(positions[i]);
+      if (window.getActiveSymbol() == symbol) {
+        break;
+      }
+    }
+    if (positions[i] == RotorWiring::MAX_SYMBOLS) {
+      fprintf(stderr, "Rotor '%s' has no symbol '%c'\n", modelName.c_str(),
+              symbol);
+      return 1;
+    }
+  }
+
+  std::vector<Cable> cables(activePlugs_.size(), Cable('\0', '\0'));
+  std::array<bool, RotorWiring::MAX_SYMBOLS> plugged = {};
+  size_t cableCount = 0;
+  std::stringstream stream(key.substr(start));
+  std::string pair;
+  while (stream >> pair) {
+    if (pair.length() != 2 || !isalpha((unsigned char)pair[0]) ||
+        !isalpha((unsigned char)pair[1])) {
+      fprintf(stderr, "Plug pair '%s' is not two letters\n", pair.c_str());
+      return 1;
+    }
+    unsigned int input = toupper((unsigned char)pair[0]) - 'A';
+    unsigned int output = toupper((unsigned char)pair[1]) - 'A';
+    if (input == output) {
+      fprintf(stderr, "Plug pair '%s' needs two different letters\n",
+              pair.c_str());
+      return 1;
+    }
+    if (plugged[input] || plugged[output]) {
+      fprintf(stderr, "Plug pair '%s' overlaps another plug\n", pair.c_str());
+      return 1;
+    }
+    if (cableCount == cables.size()) {
+      fprintf(stderr, "At most %zu plug pairs\n", cables.size());
+      return 1;
+    }
+    plugged[input] = plugged[output] = true;
+    cables[cableCount++] = Cable(pair[0], pair[1]);
+  }
+
+  setRotorOrder(order);
+  setRotorPositions(positions);
+  activePlugs_ = cables;
+  return 0;
+}
+
+std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>
+EnigmaMachine::getRotorPositions() const {
+  std::array<unsigned int, MAX_ROTORS_> positions = {};
+  for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
+    positions[i] = activeRotors_[i].getPosition();
+  }
+  return positions;
+}
+
+std::string EnigmaMachine::describeKey() const {
+  std::string description;
+  for (unsigned int i = 0; i < MAX_ROTORS_; ++i) {
+    const Rotor &rotor = activeRotors_[i];
+    description += rotor.getModelName() + '[' + rotor.getActiveSymbol() + ']';
+    if (i + 1 < MAX_ROTORS_) {
+      description += "  ";
+    }
+  }
+
+  const char *separator = "  ";
+  for (const auto &cable : activePlugs_) {
+    if (cable.input_ != '\0' && cable.output_ != '\0') {
+      description += separator;
+      description += cable.input_;
+      description += cable.output_;
+      separator = " ";
+    }
+  }
+  return description;
+}
+
+Permutation EnigmaMachine::getPlugBoardPermutation() const {
+  Permutation plugBoard;
+  for (const auto &cable : activePlugs_) {
+    if (cable.input_ != '\0' && cable.output_ != '\0') {
+      plugBoard = plugBoard.then(
+          Permutation::transposition(cable.input_ - 'A', cable.output_ - 'A'));
+    }
+  }
+  return plugBoard;
+}
+
+const Reflector &EnigmaMachine::getReflector() const {
+  return currentReflector_;
+}
+
+Permutation EnigmaMachine::getPermutation() const {
+  Permutation plugBoard = getPlugBoardPermutation();
+  return plugBoard.then(getRotorPermutation(0)).then(plugBoard.inverse());
+}
+
+Permutation EnigmaMachine::getRotorPermutation(unsigned int first) const {
+  Permutation result;
+  for (unsigned int i = first; i < MAX_ROTORS_; ++i) {
+    result = result.then(activeRotors_[i].getPermutation(-1));
+  }
+  result = result.then(currentReflector_.getPermutation(-1));
+  for (unsigned int i = MAX_ROTORS_; i > first; --i) {
+    result = result.then(activeRotors_[i - 1].getPermutation(1));
+  }
+  return result;
+}
+
 void EnigmaMachine::setSymbol(const Rotor &rotor, int direction) {
   auto it = std::find_if(activeRotors_.begin(), activeRotors_.end(),
                          [&rotor](const Rotor &r) { return r == rotor; });
@@ -234,14 +460,31 @@ void EnigmaMachine::setSymbol(const Rotor &rotor, int direction) {
   }
 }
 
-const std::vector<Rotor> &EnigmaMachine::getAvaliableRotors() const {
+std::span<const Rotor> EnigmaMachine::getAvaliableRotors() const {
   return avaliableRotors_;
 }
 
-const std::vector<Rotor> &EnigmaMachine::getActiveRotors() const {
+std::vector<std::array<unsigned int, EnigmaMachine::MAX_ROTORS_>>
+EnigmaMachine::getRotorOrders() const {
+  const unsigned int rotorCount = avaliableRotors_.size();
+  std::vector<std::array<unsigned int, MAX_ROTORS_>> orders;
+  for (unsigned int a = 0; a < rotorCount; ++a) {
+    for (unsigned int b = 0; b < rotorCount; ++b) {
+      for (unsigned int c = 0; c < rotorCount; ++c) {
+        if (a != b && b != c && a != c) {
+          orders.push_back({a, b, c});
+        }
+      }
+    }
+  }
+  return orders;
+}
+
+std::span<const Rotor, EnigmaMachine::MAX_ROTORS_>
+EnigmaMachine::getActiveRotors() const {
   return activeRotors_;
 }
 
-const std::vector<Cable> &EnigmaMachine::getActivePlugs() const {
+std::span<const Cable> EnigmaMachine::getActivePlugs() const {
   return activePlugs_;
 }
@@ -0,0 +1,135 @@
+#include "../include/KeyCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace {
+
+bool hasFailed(
+    const std::shared_future<std::shared_ptr<const CompiledKey>> &key) {
+  if (key.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return false;
+  }
+  try {
+    key.get();
+  } catch (...) {
+    return true;
+  }
+  return false;
+}
+
+} // namespace
+
+KeyConfiguration KeyConfiguration::fromMachine(const EnigmaMachine &machine) {
+  KeyConfiguration configuration;
+  std::span<const Rotor, EnigmaMachine::MAX_ROTORS_> rotors =
+      machine.getActiveRotors();
+  for (unsigned int i = 0; i < EnigmaMachine::MAX_ROTORS_; ++i) {
+    configuration.rotors[i] = rotors[i].getWiringId();
+  }
+  configuration.reflector = machine.getReflector().getWiringId();
+
+  Permutation plugBoard = machine.getPlugBoardPermutation();
+  for (unsigned int i = 0; i < Permutation::SIZE; ++i) {
+    configuration.plugBoard[i] = plugBoard[i];
+  }
+  return configuration;
+}
+
+uint64_t KeyConfiguration::hash() const {
+  const uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+  const uint64_t FNV_PRIME = 0x100000001B3ull;
+
+  uint64_t result = FNV_OFFSET;
+  auto add = [&](uint8_t byte) {
+    result ^= byte;
+    result *= FNV_PRIME;
+  };
+  for (const uint16_t rotor : rotors) {
+    add(rotor & 0xFF);
+    add(rotor >> 8);
+  }
+  add(reflector & 0xFF);
+  add(reflector >> 8);
+  for (const uint8_t letter : plugBoard) {
+    add(letter);
+  }
+  return result;
+}
+
+KeyCache::KeyCache(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {
+  stats_.capacity = capacity_;
+}
+
+KeyCache &KeyCache::getShared() {
+  static KeyCache cache;
+  return cache;
+}
+
+std::shared_ptr<const CompiledKey> KeyCache::get(const EnigmaMachine &machine) {
+  KeyConfiguration configuration = KeyConfiguration::fromMachine(machine);
+  std::promise<std::shared_ptr<const CompiledKey>> compiled;
+  std::shared_future<std::shared_ptr<const CompiledKey>> key;
+  bool compiling = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(configuration);
+    if (it != entries_.end()) {
+      recent_.splice(recent_.begin(), recent_, it->second);
+      stats_.hits++;
+      key = it->second->second;
+    } else {
+      stats_.misses++;
+      key = compiled.get_future().share();
+      recent_.emplace_front(configuration, key);
+      entries_[configuration] = recent_.begin();
+      stats_.bytes += CompiledKey::getTableBytes();
+      while (recent_.size() > capacity_) {
+        stats_.bytes -= CompiledKey::getTableBytes();
+        entries_.erase(recent_.back().first);
+        recent_.pop_back();
+        stats_.evictions++;
+      }
+      stats_.entries = recent_.size();
+      compiling = true;
+    }
+  }
+
+  if (compiling) {
+    EnigmaMachine stepper = machine;
+    stepper.setRotorPositions({0, 0, 0});
+    try {
+      compiled.set_value(CompiledKey::compile(stepper));
+    } catch (...) {
+      compiled.set_exception(std::current_exception());
+      forget(configuration);
+      throw;
+    }
+  }
+  return key.get();
+}
+
+void KeyCache::forget(const KeyConfiguration &configuration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(configuration);
+  if (it == entries_.end() || !hasFailed(it->second->second)) {
+    return;
+  }
+  recent_.erase(it->second);
+  entries_.erase(it);
+  stats_.bytes -= CompiledKey::getTableBytes();
+  stats_.entries = recent_.size();
+}
+
+KeyCacheStats KeyCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void KeyCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  recent_.clear();
+  entries_.clear();
+  stats_.entries = 0;
+  stats_.bytes = 0;
+}
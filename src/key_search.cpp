@@ -0,0 +1,398 @@
+#include "../include/KeySearch.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t JOB_MAGIC[2] = {0x47494E45, 0x31435253};        // "ENIGSRC1"
+const uint32_t CHECKPOINT_MAGIC[2] = {0x47494E45, 0x32504B43}; // "ENIGCKP2"
+const unsigned int JOB_HEADER_WORDS = 6;
+const unsigned int CHECKPOINT_HEADER_WORDS = 7;
+const unsigned int RESULT_WORDS = 3;
+const unsigned int LETTERS = 26;
+const unsigned int KEYS_PER_CLOCK_CHECK = 1024;
+
+bool isBetter(const SearchResult &a, const SearchResult &b) {
+  return a.score > b.score || (a.score == b.score && a.key < b.key);
+}
+
+void keepResult(std::vector<SearchResult> &results, unsigned int keep,
+                const SearchResult &result) {
+  if (results.size() < keep) {
+    results.push_back(result);
+    std::push_heap(results.begin(), results.end(), isBetter);
+  } else if (keep > 0 && isBetter(result, results.front())) {
+    std::pop_heap(results.begin(), results.end(), isBetter);
+    results.back() = result;
+    std::push_heap(results.begin(), results.end(), isBetter);
+  }
+}
+
+bool readWords(FILE *file, uint32_t *words, size_t count) {
+  return fread(words, sizeof(uint32_t), count, file) == count;
+}
+
+} // namespace
+
+int KeySearch::create(const std::string &directory,
+                      const std::string &ciphertext, unsigned int shards,
+                      unsigned int keep) {
+  FILE *input = ciphertext == "-" ? stdin : fopen(ciphertext.c_str(), "rb");
+  if (!input) {
+    perror(ciphertext.c_str());
+    return 1;
+  }
+  std::vector<uint8_t> letters;
+  int character = 0;
+  while ((character = fgetc(input)) != EOF) {
+    unsigned int index = (unsigned char)(character | 0x20) - 'a';
+    if (index < LETTERS) {
+      letters.push_back(index);
+    }
+  }
+  if (input != stdin) {
+    fclose(input);
+  }
+  if (letters.size() < 2) {
+    fprintf(stderr, "Ciphertext needs at least two letters\n");
+    return 1;
+  }
+
+  EnigmaMachine machine = setupEnigmaMachine();
+  uint32_t orderCount = machine.getRotorOrders().size();
+  shards = std::clamp<unsigned int>(shards, 1, orderCount * POSITIONS);
+
+  if (mkdir(directory.c_str(), 0755) == -1 && errno != EEXIST) {
+    perror(directory.c_str());
+    return 1;
+  }
+  std::string path = directory + "/job";
+  if (access(path.c_str(), F_OK) == 0) {
+    fprintf(stderr, "%s already holds a search\n", directory.c_str());
+    return 1;
+  }
+
+  uint32_t header[JOB_HEADER_WORDS] = {JOB_MAGIC[0], JOB_MAGIC[1], orderCount,
+                                       shards,       keep,
+                                       (uint32_t)letters.size()};
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+  bool written =
+      fwrite(header, sizeof(uint32_t), JOB_HEADER_WORDS, file) ==
+          JOB_HEADER_WORDS &&
+      fwrite(letters.data(), 1, letters.size(), file) == letters.size();
+  if (fclose(file) != 0 || !written) {
+    perror(path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+int KeySearch::open(const std::string &directory) {
+  directory_ = directory;
+  std::string path = directory_ + "/job";
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  uint32_t header[JOB_HEADER_WORDS] = {};
+  orders_ = machine_.getRotorOrders();
+  bool valid = readWords(file, header, JOB_HEADER_WORDS) &&
+               header[0] == JOB_MAGIC[0] && header[1] == JOB_MAGIC[1] &&
+               header[2] == orders_.size() && header[3] > 0;
+  if (valid) {
+    shardCount_ = header[3];
+    keep_ = header[4];
+    letters_.resize(header[5]);
+    valid = fread(letters_.data(), 1, letters_.size(), file) == letters_.size();
+  }
+  fclose(file);
+
+  if (!valid) {
+    fprintf(stderr, "%s is not a search for this machine\n", path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+unsigned int KeySearch::getShardCount() const { return shardCount_; }
+
+uint32_t KeySearch::getKeyCount() const { return orders_.size() * POSITIONS; }
+
+std::string KeySearch::getShardPath(unsigned int shard,
+                                    const char *extension) const {
+  char name[32];
+  snprintf(name, sizeof(name), "/shard-%05u.%s", shard, extension);
+  return directory_ + name;
+}
+
+int KeySearch::loadShard(unsigned int shard, SearchShard &state) const {
+  state = SearchShard();
+  state.firstKey = (uint64_t)getKeyCount() * shard / shardCount_;
+  state.lastKey = (uint64_t)getKeyCount() * (shard + 1) / shardCount_;
+  state.nextKey = state.firstKey;
+
+  FILE *file = fopen(getShardPath(shard, "ckpt").c_str(), "rb");
+  if (!file) {
+    return 0;
+  }
+
+  uint32_t header[CHECKPOINT_HEADER_WORDS] = {};
+  std::vector<uint32_t> words;
+  bool valid = readWords(file, header, CHECKPOINT_HEADER_WORDS) &&
+               header[0] == CHECKPOINT_MAGIC[0] &&
+               header[1] == CHECKPOINT_MAGIC[1] && header[2] == shard &&
+               header[3] >= state.firstKey && header[4] == state.lastKey &&
+               (header[3] < state.lastKey ||
+                (header[3] == state.lastKey && header[5] != 0)) &&
+               header[6] <= keep_;
+  if (valid) {
+    words.resize(header[6] * RESULT_WORDS);
+    valid = readWords(file, words.data(), words.size());
+  }
+  fclose(file);
+
+  for (size_t i = 0; valid && i < header[6]; ++i) {
+    const uint32_t *result = words.data() + i * RESULT_WORDS;
+    SearchResult loaded = {(uint64_t)result[1] << 32 | result[0], result[2]};
+    valid = loaded.key >= state.firstKey && loaded.key < header[3];
+    state.results.push_back(loaded);
+  }
+
+  if (!valid) {
+    fprintf(stderr, "Ignoring damaged checkpoint for shard %u\n", shard);
+    state.results.clear();
+    return 1;
+  }
+  state.nextKey = header[3];
+  state.done = header[5] != 0;
+  std::make_heap(state.results.begin(), state.results.end(), isBetter);
+  return 0;
+}
+
+int KeySearch::saveShard(unsigned int shard, const SearchShard &state) const {
+  std::string path = getShardPath(shard, "ckpt");
+  std::string temporaryPath = path + ".tmp";
+  uint32_t header[CHECKPOINT_HEADER_WORDS] = {
+      CHECKPOINT_MAGIC[0], CHECKPOINT_MAGIC[1],
+      shard,               state.nextKey,
+      state.lastKey,       state.done,
+      (uint32_t)state.results.size()};
+  std::vector<uint32_t> words;
+  for (const auto &result : state.results) {
+    words.push_back(result.score & 0xFFFFFFFF);
+    words.push_back(result.score >> 32);
+    words.push_back(result.key);
+  }
+
+  FILE *file = fopen(temporaryPath.c_str(), "wb");
+  if (!file) {
+    perror(temporaryPath.c_str());
+    return 1;
+  }
+  bool written =
+      fwrite(header, sizeof(uint32_t), CHECKPOINT_HEADER_WORDS, file) ==
+          CHECKPOINT_HEADER_WORDS &&
+      fwrite(words.data(), sizeof(uint32_t), words.size(), file) ==
+          words.size() &&
+      fflush(file) == 0 && fsync(fileno(file)) == 0;
+  if (fclose(file) != 0 || !written ||
+      rename(temporaryPath.c_str(), path.c_str()) == -1) {
+    perror(path.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+void KeySearch::compileOrder(unsigned int order) {
+  if (compiledOrder_ == (int)order) {
+    return;
+  }
+  machine_.setRotorOrder(orders_[order]);
+  orderKey_ = CompiledKey::compile(machine_);
+  compiledOrder_ = order;
+}
+
+int KeySearch::runShard(unsigned int shard, SearchShard &state) {
+  auto lastCheckpoint = std::chrono::steady_clock::now();
+  while (state.nextKey < state.lastKey) {
+    uint32_t key = state.nextKey;
+    compileOrder(key / POSITIONS);
+
+    const CompiledKey &orderKey = *orderKey_;
+    std::array<uint32_t, LETTERS> counts = {};
+    KeyCursor cursor = {(uint16_t)(key % POSITIONS)};
+    for (const uint8_t letter : letters_) {
+      counts[orderKey.getPermutation(cursor)[letter]]++;
+      cursor = orderKey.getNext(cursor);
+    }
+    uint64_t score = 0;
+    for (const uint32_t count : counts) {
+      score += (uint64_t)count * (count - 1);
+    }
+    keepResult(state.results, keep_, {score, key});
+    state.nextKey++;
+
+    if (state.nextKey % KEYS_PER_CLOCK_CHECK == 0) {
+      auto now = std::chrono::steady_clock::now();
+      if (now - lastCheckpoint >= std::chrono::seconds(CHECKPOINT_SECONDS)) {
+        if (saveShard(shard, state)) {
+          return 1;
+        }
+        lastCheckpoint = now;
+      }
+    }
+  }
+
+  state.done = true;
+  return saveShard(shard, state);
+}
+
+int KeySearch::work(unsigned int firstShard) {
+  bool claimed = true;
+  while (claimed) {
+    claimed = false;
+    for (unsigned int i = 0; i < shardCount_; ++i) {
+      unsigned int shard = (firstShard + i) % shardCount_;
+      SearchShard state;
+      loadShard(shard, state);
+      if (state.done) {
+        continue;
+      }
+
+      std::string lockPath = getShardPath(shard, "lock");
+      int lock = ::open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+      if (lock == -1) {
+        perror(lockPath.c_str());
+        return 1;
+      }
+      if (flock(lock, LOCK_EX | LOCK_NB) == -1) {
+        ::close(lock);
+        continue;
+      }
+
+      loadShard(shard, state);
+      int error = state.done ? 0 : runShard(shard, state);
+      ::close(lock);
+      if (error) {
+        return 1;
+      }
+      claimed = true;
+    }
+  }
+  return 0;
+}
+
+std::vector<SearchResult> KeySearch::merge(unsigned int &shardsDone,
+                                           uint64_t &keysSearched) const {
+  std::vector<SearchResult> results;
+  shardsDone = 0;
+  keysSearched = 0;
+  for (unsigned int shard = 0; shard < shardCount_; ++shard) {
+    SearchShard state;
+    loadShard(shard, state);
+    shardsDone += state.done;
+    keysSearched += state.nextKey - state.firstKey;
+    for (const auto &result : state.results) {
+      keepResult(results, keep_, result);
+    }
+  }
+  std::sort(results.begin(), results.end(), isBetter);
+  return results;
+}
+
+double KeySearch::getIndexOfCoincidence(uint64_t score) const {
+  double letters = letters_.size();
+  return score / (letters * (letters - 1));
+}
+
+std::string KeySearch::describeKey(uint32_t key) const {
+  EnigmaMachine machine = machine_;
+  machine.setRotorOrder(orders_[key / POSITIONS % orders_.size()]);
+  machine.setRotorPositions(
+      CompiledKey::getPositions({(uint16_t)(key % POSITIONS)}));
+  return machine.describeKey();
+}
+
+int createKeySearch(const std::string &directory,
+                    const std::string &ciphertext, unsigned int shards,
+                    unsigned int keep) {
+  return KeySearch::create(directory, ciphertext, shards, keep);
+}
+
+int runKeySearch(const std::string &directory, unsigned int processes) {
+  KeySearch search;
+  if (search.open(directory)) {
+    return 1;
+  }
+  if (processes == 0) {
+    processes = std::max(1u, std::thread::hardware_concurrency());
+  }
+  processes = std::min(processes, search.getShardCount());
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<pid_t> workers;
+  for (unsigned int i = 0; i < processes; ++i) {
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == -1) {
+      perror("fork");
+      break;
+    } else if (pid == 0) {
+      _exit(search.work(i * search.getShardCount() / processes));
+    }
+    workers.push_back(pid);
+  }
+
+  int error = workers.empty();
+  for (const pid_t pid : workers) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      error = 1;
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  unsigned int shardsDone = 0;
+  uint64_t keysSearched = 0;
+  search.merge(shardsDone, keysSearched);
+  fprintf(stderr, "processes=%zu shards=%u/%u keys=%llu/%u (%.1fs)\n",
+          workers.size(), shardsDone, search.getShardCount(),
+          (unsigned long long)keysSearched, search.getKeyCount(), seconds);
+  return error || printKeySearch(directory, 10);
+}
+
+int printKeySearch(const std::string &directory, unsigned int limit) {
+  KeySearch search;
+  if (search.open(directory)) {
+    return 1;
+  }
+
+  unsigned int shardsDone = 0;
+  uint64_t keysSearched = 0;
+  std::vector<SearchResult> results = search.merge(shardsDone, keysSearched);
+  printf("%u/%u shards done, %llu/%u keys searched\n", shardsDone,
+         search.getShardCount(), (unsigned long long)keysSearched,
+         search.getKeyCount());
+  for (size_t i = 0; i < results.size() && i < limit; ++i) {
+    printf("%.5f  %s\n", search.getIndexOfCoincidence(results[i].score),
+           search.describeKey(results[i].key).c_str());
+  }
+  return 0;
+}
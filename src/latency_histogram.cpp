@@ -0,0 +1,86 @@
+#include "../include/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cstdio>
+
+void LatencyHistogram::record(Clock::duration latency) {
+  uint64_t microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+  size_t bucket = 0;
+  if (microseconds < FINE_BUCKETS_) {
+    bucket = microseconds;
+  } else if (microseconds / 1000 < COARSE_BUCKETS_) {
+    bucket = FINE_BUCKETS_ + microseconds / 1000;
+  } else {
+    bucket = buckets_.size() - 1;
+  }
+
+  buckets_[bucket]++;
+  count_++;
+  totalMicroseconds_ += microseconds;
+  maxMicroseconds_ = std::max(maxMicroseconds_, microseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  totalMicroseconds_ += other.totalMicroseconds_;
+  maxMicroseconds_ = std::max(maxMicroseconds_, other.maxMicroseconds_);
+}
+
+void LatencyHistogram::clear() { *this = LatencyHistogram(); }
+
+uint64_t LatencyHistogram::getCount() const { return count_; }
+
+uint64_t LatencyHistogram::getMaxMicroseconds() const {
+  return maxMicroseconds_;
+}
+
+double LatencyHistogram::getMeanMicroseconds() const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  return (double)totalMicroseconds_ / count_;
+}
+
+uint64_t LatencyHistogram::getPercentileMicroseconds(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  uint64_t target = (uint64_t)(percentile / 100.0 * count_);
+  if (target >= count_) {
+    target = count_ - 1;
+  }
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen > target) {
+      if (i < FINE_BUCKETS_) {
+        return i;
+      } else if (i < buckets_.size() - 1) {
+        return (i - FINE_BUCKETS_) * 1000;
+      }
+      return maxMicroseconds_;
+    }
+  }
+
+  return maxMicroseconds_;
+}
+
+std::string LatencyHistogram::summary() const {
+  char line[160];
+  snprintf(line, sizeof(line),
+           "count=%llu mean=%.1fus p50=%lluus p90=%lluus p99=%lluus "
+           "p99.9=%lluus max=%lluus",
+           (unsigned long long)count_, getMeanMicroseconds(),
+           (unsigned long long)getPercentileMicroseconds(50),
+           (unsigned long long)getPercentileMicroseconds(90),
+           (unsigned long long)getPercentileMicroseconds(99),
+           (unsigned long long)getPercentileMicroseconds(99.9),
+           (unsigned long long)maxMicroseconds_);
+  return line;
+}
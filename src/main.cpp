@@ -1,90 +1,336 @@
+#include "../include/Banburismus.hpp"
+#include "../include/CompiledKey.hpp"
+#include "../include/CribScanner.hpp"
+#include "../include/CycleCatalog.hpp"
+#include "../include/Daemon.hpp"
 #include "../include/Display.hpp"
+#include "../include/Engine.hpp"
 #include "../include/EnigmaMachine.hpp"
+#include "../include/KeySearch.hpp"
+#include "../include/MessageEditor.hpp"
+#include "../include/RenderBenchmark.hpp"
+#include "../include/SessionRecorder.hpp"
+#include "../include/TextFormat.hpp"
+#include "../include/TextStatistics.hpp"
+#include "../include/TrafficGenerator.hpp"
+#include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <ncurses.h>
+#include <string>
 
-int main(void) {
+static void printUsage(const char *program) {
+  fprintf(stderr,
+          "Usage: %s [command]\n"
+          "  [--fps N] [--single-thread]        interactive machine\n"
+          "  [--record FILE]                    record keystrokes while "
+          "running\n"
+          "  [--replay FILE [--real-time]]      replay a recording headless "
+          "and\n"
+          "                                     report frame latency\n"
+          "  daemon [socket]                    serve sessions over a UNIX "
+          "socket\n"
+          "  client [socket] [connections] [requests] [length] [pipeline]\n"
+          "                                     load test a running daemon\n"
+          "  cursor-bench [threads] [letters]   compare machine copies with "
+          "cursors\n"
+          "                                     over one shared compiled key\n"
+          "  render-bench [keys] [rows] [columns]\n"
+          "                                     time each panel on an "
+          "in-memory canvas\n"
+          "  catalog build [file] [threads]     build the cycle structure "
+          "catalog\n"
+          "  encrypt [file] [--pass-through|--historical] [--no-groups]\n"
+          "                                     encrypt a file in 5 letter "
+          "groups\n"
+          "  edit [file] [interval]             edit a message line by line, "
+          "re-encrypting\n"
+          "                                     only what the edit changes\n"
+          "  generate <dir> [messages] [length] [shards] [seed] [threads]\n"
+          "                                     write seeded traffic with "
+          "ground truth keys\n"
+          "  stats [file]                       letter, bigram and IC "
+          "statistics of a file\n"
+          "  crib <file> <CRIB> [--count]       list offsets where the crib "
+          "can sit\n"
+          "  search init <dir> <file> [shards] [keep]\n"
+          "                                     split a rotor order and "
+          "position\n"
+          "                                     search of a ciphertext into "
+          "shards\n"
+          "  search run <dir> [processes]       work the shards, resuming "
+          "checkpoints\n"
+          "  search show <dir> [limit]          merged ranking of all shards\n"
+          "  banburismus <file> [overlap] [limit] [threads]\n"
+          "                                     score every pair of messages "
+          "(one per\n"
+          "                                     line) at every offset\n"
+          "  catalog query <file> <AD> <BE> <CF> [limit]\n"
+          "                                     list settings with the given "
+          "cycle\n"
+          "                                     lengths, e.g. 13,13 1,1,12,12 "
+          "...\n",
+          program);
+}
+
+struct InteractiveOptions {
+  unsigned int framesPerSecond = 60;
+  bool singleThread = false;
+  std::string recordPath = "";
+  std::string replayPath = "";
+  bool realTime = false;
+};
+
+static int runCommand(int argc, char *argv[]) {
+  std::string command = argv[1];
+  auto argument = [&](int index, const char *fallback) {
+    return std::string(argc > index ? argv[index] : fallback);
+  };
+  auto number = [&](int index, unsigned int fallback) {
+    return argc > index ? (unsigned int)strtoul(argv[index], nullptr, 10)
+                        : fallback;
+  };
+
+  if (command == "daemon") {
+    return runDaemon(argument(2, DEFAULT_SOCKET_PATH));
+  } else if (command == "client") {
+    return runClient(argument(2, DEFAULT_SOCKET_PATH), number(3, 8),
+                     number(4, 10000), number(5, 32), number(6, 1));
+  } else if (command == "encrypt") {
+    TextFormat::Policy policy = TextFormat::FILTER;
+    bool grouped = true;
+    std::string path = "-";
+    for (int i = 2; i < argc; ++i) {
+      std::string option = argv[i];
+      if (option == "--pass-through") {
+        policy = TextFormat::PASS_THROUGH;
+      } else if (option == "--historical") {
+        policy = TextFormat::HISTORICAL;
+      } else if (option == "--no-groups") {
+        grouped = false;
+      } else {
+        path = option;
+      }
+    }
+    return encryptFile(path, policy, grouped);
+  } else if (command == "edit") {
+    return runMessageEditor(
+        argument(2, "-"),
+        number(3, MessageEditor::DEFAULT_CHECKPOINT_INTERVAL));
+  } else if (command == "generate" && argc > 2) {
+    TrafficGenerator::Options options;
+    options.messages = number(3, options.messages);
+    options.length = number(4, options.length);
+    options.shards = number(5, options.shards);
+    if (argc > 6) {
+      options.seed = strtoull(argv[6], nullptr, 10);
+    }
+    options.threads = number(7, options.threads);
+    return generateTraffic(argv[2], options);
+  } else if (command == "stats") {
+    return printTextStatistics(argument(2, "-"));
+  } else if (command == "cursor-bench") {
+    return runCursorBenchmark(number(2, 0), number(3, 1 << 22));
+  } else if (command == "render-bench") {
+    return runRenderBenchmark(number(2, 10000), number(3, 40), number(4, 120));
+  } else if (command == "banburismus" && argc > 2) {
+    return printBanburismus(argv[2], number(3, 40), number(4, 20),
+                            number(5, 0));
+  } else if (command == "crib" && argc > 3) {
+    return printCribPositions(argv[2], argv[3], argument(4, "") == "--count");
+  } else if (command == "search" && argument(2, "") == "init" && argc > 4) {
+    return createKeySearch(argv[3], argv[4], number(5, 240), number(6, 20));
+  } else if (command == "search" && argument(2, "") == "run" && argc > 3) {
+    return runKeySearch(argv[3], number(4, 0));
+  } else if (command == "search" && argument(2, "") == "show" && argc > 3) {
+    return printKeySearch(argv[3], number(4, 20));
+  } else if (command == "catalog" && argument(2, "") == "build") {
+    return buildCycleCatalog(argument(3, "cycles.catalog"), number(4, 0));
+  } else if (command == "catalog" && argument(2, "") == "query" && argc > 6) {
+    return queryCycleCatalog(argv[3], {argv[4], argv[5], argv[6]},
+                             number(7, 20));
+  }
+
+  printUsage(argv[0]);
+  return 1;
+}
+
+static int runInteractive(const InteractiveOptions &options) {
   WINDOW *windowMain = nullptr;
   Subwindows subwindows;
-  EnigmaMachine enigmaMachine = setupEnigmaMachine();
+
+  if (!options.replayPath.empty()) {
+    if (startReplay(options.replayPath, options.realTime) ||
+        setupReplayTerminal()) {
+      return 1;
+    }
+  }
 
   int error = setupWindows(windowMain, subwindows);
   if (error) {
     endwin();
+    finishSession();
+    return 1;
+  }
+
+  if (!options.recordPath.empty() && startRecording(options.recordPath)) {
+    endwin();
+    finishSession();
     return 1;
   }
 
+  NcursesCanvas canvasRotors(subwindows.rotors);
+  NcursesCanvas canvasOutput(subwindows.output);
+  NcursesCanvas canvasStatistics(subwindows.statistics);
+  NcursesCanvas canvasKeyboard(subwindows.keyboard);
+  NcursesCanvas canvasPlugBoard(subwindows.plugBoard);
+  NcursesCanvas canvasMain(windowMain);
+  SubwindowCanvases canvases = {&canvasRotors, &canvasOutput,
+                                &canvasStatistics, &canvasKeyboard,
+                                &canvasPlugBoard};
+
   const int ESC_KEY = 27;
   const int SPACE_KEY = 32;
   const int ENTER_KEY = 10;
+  const auto KEY_HIGHLIGHT_DURATION = std::chrono::seconds(1);
+  const auto FRAME_INTERVAL = std::chrono::microseconds(
+      1000000 / std::max(1u, options.framesPerSecond));
+
+  Engine engine(setupEnigmaMachine());
+  engine.setOutputCapacity(getOutputCapacity(canvasOutput));
+  const bool frameCapped = !isFullSpeedReplay();
+  if (!options.singleThread && frameCapped) {
+    engine.start();
+  }
+
+  unsigned long long keyPressesSeen = 0;
+  char highlightedKey = 0;
+  auto highlightUntil = std::chrono::steady_clock::now();
+  auto nextFrame = std::chrono::steady_clock::now();
+  bool redraw = true;
+  bool framePending = true;
 
   int keyPress = 0;
+  bool running = true;
+  while (running) {
+    auto wait = FRAME_INTERVAL;
+    if (framePending) {
+      wait = std::chrono::duration_cast<std::chrono::microseconds>(
+          nextFrame - std::chrono::steady_clock::now());
+    }
+    timeout(std::max(1, (int)((wait.count() + 999) / 1000)));
+    while ((keyPress = readKey()) != ERR) {
+      timeout(0);
 
-  do {
-    if (isalpha(keyPress)) {
-      keyPress = toupper(keyPress);
-      char encryptedLetter = keyPress;
-      enigmaMachine.encrypt(encryptedLetter);
-
-      drawKeyboard(subwindows.keyboard, keyPress);
-      bool shouldSpin = drawOutput(subwindows.output, encryptedLetter);
-      if (shouldSpin) {
-        enigmaMachine.spinRotors(-1);
-        drawRotors(subwindows.rotors, enigmaMachine);
-      }
+      if (keyPress < 128 && isalpha(keyPress)) {
+        engine.submit(toupper(keyPress));
+      } else if (keyPress == SPACE_KEY) {
+        engine.submit(' ');
+      } else if (keyPress == KEY_BACKSPACE) {
+        engine.submit(Engine::BACKSPACE);
+      } else if (keyPress == ESC_KEY || keyPress == KEY_UP ||
+                 keyPress == KEY_DOWN) {
+        engine.pause();
+        timeout(-1);
 
-      drawPlugBoard(subwindows.plugBoard, enigmaMachine);
-    } else if (keyPress == SPACE_KEY) {
-      drawOutput(subwindows.output, SPACE_KEY);
-    } else if (keyPress == KEY_BACKSPACE) {
-      bool shouldSpin = drawOutput(subwindows.output, KEY_BACKSPACE);
-      if (shouldSpin) {
-        enigmaMachine.spinRotors(1);
-        drawRotors(subwindows.rotors, enigmaMachine);
-      }
-    } else if (keyPress == ESC_KEY) {
-      bool reset =
-          escapeMenu(subwindows.output, enigmaMachine, ESC_KEY, ENTER_KEY);
-
-      wclear(subwindows.output);
-      drawOutput(subwindows.output, 0, reset);
-      if (reset) {
-        clearWindows(windowMain, subwindows);
-        drawKeyboard(subwindows.keyboard, keyPress);
-        drawRotors(subwindows.rotors, enigmaMachine);
-        drawPlugBoard(subwindows.plugBoard, enigmaMachine);
+        EnigmaMachine &enigmaMachine = engine.getMachine();
+        if (keyPress == ESC_KEY) {
+          EscapeAction action =
+              escapeMenu(canvasOutput, enigmaMachine, ESC_KEY, ENTER_KEY);
+          if (action == ESCAPE_EXIT) {
+            running = false;
+          } else if (action == ESCAPE_RESET) {
+            engine.resetOutput();
+            clearWindows(canvasMain, canvases);
+          }
+        } else if (keyPress == KEY_UP) {
+          rotorConfigMenu(canvasRotors, enigmaMachine, ESC_KEY, ENTER_KEY);
+          canvasRotors.clear();
+        } else {
+          plugBoardConfigMenu(canvasPlugBoard, enigmaMachine, ESC_KEY);
+          canvasPlugBoard.clear();
+        }
+
+        timeout(0);
+        engine.resume();
+        if (!running) {
+          break;
+        }
+        redraw = true;
+      } else if (keyPress == KEY_RESIZE) {
+        clearWindows(canvasMain, canvases);
+        engine.setOutputCapacity(getOutputCapacity(canvasOutput));
+        redraw = true;
       }
-    } else if (keyPress == KEY_RESIZE) {
-      keyPress = 0;
-      clearWindows(windowMain, subwindows);
-      drawKeyboard(subwindows.keyboard, keyPress);
-      drawOutput(subwindows.output, keyPress);
-      drawRotors(subwindows.rotors, enigmaMachine);
-      drawPlugBoard(subwindows.plugBoard, enigmaMachine);
-    } else if (keyPress == 0) {
-      drawKeyboard(subwindows.keyboard, keyPress);
-      drawRotors(subwindows.rotors, enigmaMachine);
-      drawPlugBoard(subwindows.plugBoard, enigmaMachine);
     }
-    switch (keyPress) {
-    case KEY_UP:
-      rotorConfigMenu(subwindows.rotors, enigmaMachine, ESC_KEY, ENTER_KEY);
-
-      wclear(subwindows.rotors);
-      drawRotors(subwindows.rotors, enigmaMachine);
-      break;
-    case KEY_DOWN:
-      plugBoardConfigMenu(subwindows.plugBoard, enigmaMachine, ESC_KEY);
-
-      wclear(subwindows.plugBoard);
-      drawPlugBoard(subwindows.plugBoard, enigmaMachine);
-      break;
+
+    engine.flush();
+    framePending |= engine.updateSnapshot() || redraw;
+    const EngineSnapshot &snapshot = engine.getSnapshot();
+    auto now = std::chrono::steady_clock::now();
+
+    if (snapshot.keyPresses != keyPressesSeen) {
+      keyPressesSeen = snapshot.keyPresses;
+      highlightedKey = snapshot.lastKey;
+      highlightUntil = now + KEY_HIGHLIGHT_DURATION;
+      framePending = true;
+    } else if (highlightedKey != 0 && now >= highlightUntil) {
+      highlightedKey = 0;
+      framePending = true;
+    }
+
+    if (framePending && (!frameCapped || now >= nextFrame)) {
+      drawKeyboard(canvasKeyboard, highlightedKey);
+      drawRotors(canvasRotors, snapshot.machine);
+      drawPlugBoard(canvasPlugBoard, snapshot.machine);
+      drawOutput(canvasOutput, snapshot.outputText);
+      drawStatistics(canvasStatistics, snapshot.statistics,
+                     snapshot.keyCache);
+
+      drawSubwindowBoxes(canvases);
+      refreshWindows(canvasMain, canvases);
+      markFrame();
+      redraw = false;
+      framePending = false;
+      nextFrame = now + FRAME_INTERVAL;
     }
 
-    drawSubwindowBoxes(subwindows);
-    refreshWindows(windowMain, subwindows);
-  } while ((keyPress = getch()));
+    if (isReplayFinished() && !framePending) {
+      running = false;
+    }
+  }
 
+  engine.stop();
   endwin();
+  finishSession();
   return 0;
 }
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && argv[1][0] != '-') {
+    return runCommand(argc, argv);
+  }
+
+  InteractiveOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--fps" && i + 1 < argc) {
+      options.framesPerSecond = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--single-thread") {
+      options.singleThread = true;
+    } else if (option == "--record" && i + 1 < argc) {
+      options.recordPath = argv[++i];
+    } else if (option == "--replay" && i + 1 < argc) {
+      options.replayPath = argv[++i];
+    } else if (option == "--real-time") {
+      options.realTime = true;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  return runInteractive(options);
+}
@@ -0,0 +1,215 @@
+#include "../include/MessageEditor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+bool isLetter(char symbol) {
+  return (unsigned int)((unsigned char)(symbol | 0x20) - 'a') < 26;
+}
+
+size_t countLetters(const std::string &text, size_t first, size_t count) {
+  return std::count_if(text.begin() + first, text.begin() + first + count,
+                       isLetter);
+}
+
+} // namespace
+
+MessageEditor::MessageEditor(const EnigmaMachine &machine,
+                             size_t checkpointInterval)
+    : machine_(machine),
+      checkpointInterval_(std::max<size_t>(1, checkpointInterval)) {
+  checkpoints_.push_back(machine_.getRotorPositions());
+}
+
+void MessageEditor::setMachine(const EnigmaMachine &machine) {
+  machine_ = machine;
+  checkpoints_.assign(1, machine_.getRotorPositions());
+  lastEncryptedCount_ = lastWalkedCount_ = 0;
+  encryptRange(0, plaintext_.length());
+}
+
+void MessageEditor::insert(size_t position, const std::string &text) {
+  position = std::min(position, plaintext_.length());
+  plaintext_.insert(position, text);
+  ciphertext_.insert(position, text.length(), '\0');
+  invalidateCheckpoints(position);
+
+  lastEncryptedCount_ = lastWalkedCount_ = 0;
+  bool shifted = countLetters(text, 0, text.length()) > 0;
+  encryptRange(position,
+               shifted ? plaintext_.length() : position + text.length());
+}
+
+void MessageEditor::erase(size_t position, size_t count) {
+  position = std::min(position, plaintext_.length());
+  count = std::min(count, plaintext_.length() - position);
+  bool shifted = countLetters(plaintext_, position, count) > 0;
+  plaintext_.erase(position, count);
+  ciphertext_.erase(position, count);
+  invalidateCheckpoints(position);
+
+  lastEncryptedCount_ = lastWalkedCount_ = 0;
+  if (shifted) {
+    encryptRange(position, plaintext_.length());
+  }
+}
+
+int MessageEditor::replace(size_t position, const std::string &text) {
+  if (position > plaintext_.length() ||
+      text.length() > plaintext_.length() - position) {
+    return 1;
+  }
+  size_t count = text.length();
+  bool shifted = countLetters(plaintext_, position, count) !=
+                 countLetters(text, 0, count);
+  plaintext_.replace(position, count, text, 0, count);
+  if (shifted) {
+    invalidateCheckpoints(position);
+  }
+
+  lastEncryptedCount_ = lastWalkedCount_ = 0;
+  encryptRange(position, shifted ? plaintext_.length() : position + count);
+  return 0;
+}
+
+const std::string &MessageEditor::getPlaintext() const { return plaintext_; }
+
+const std::string &MessageEditor::getCiphertext() const { return ciphertext_; }
+
+size_t MessageEditor::getLastEncryptedCount() const {
+  return lastEncryptedCount_;
+}
+
+size_t MessageEditor::getLastWalkedCount() const { return lastWalkedCount_; }
+
+void MessageEditor::invalidateCheckpoints(size_t position) {
+  checkpoints_.resize(
+      std::min(checkpoints_.size(), position / checkpointInterval_ + 1));
+}
+
+void MessageEditor::restore(size_t position) {
+  size_t checkpoint =
+      std::min(position / checkpointInterval_, checkpoints_.size() - 1);
+  machine_.setRotorPositions(checkpoints_[checkpoint]);
+  for (size_t i = checkpoint * checkpointInterval_; i < position; ++i) {
+    advance(i, false);
+  }
+}
+
+void MessageEditor::encryptRange(size_t first, size_t last) {
+  restore(first);
+  for (size_t i = first; i < last; ++i) {
+    advance(i, true);
+  }
+}
+
+void MessageEditor::advance(size_t index, bool encrypt) {
+  if (index % checkpointInterval_ == 0) {
+    size_t checkpoint = index / checkpointInterval_;
+    if (checkpoint < checkpoints_.size()) {
+      checkpoints_[checkpoint] = machine_.getRotorPositions();
+    } else if (checkpoint == checkpoints_.size()) {
+      checkpoints_.push_back(machine_.getRotorPositions());
+    }
+  }
+
+  char letter = plaintext_[index];
+  if (!isLetter(letter)) {
+    lastWalkedCount_ += !encrypt;
+    if (encrypt) {
+      ciphertext_[index] = letter;
+    }
+    return;
+  }
+
+  if (encrypt) {
+    letter &= ~0x20;
+    machine_.encrypt(letter);
+    ciphertext_[index] = letter;
+    lastEncryptedCount_++;
+  } else {
+    lastWalkedCount_++;
+  }
+  machine_.spinRotors(-1);
+}
+
+int runMessageEditor(const std::string &path, size_t checkpointInterval) {
+  std::string message;
+  if (path != "-") {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+      perror(path.c_str());
+      return 1;
+    }
+    int character = 0;
+    while ((character = fgetc(file)) != EOF) {
+      message += (char)character;
+    }
+    fclose(file);
+  }
+
+  EnigmaMachine key = setupEnigmaMachine();
+  MessageEditor editor(key, checkpointInterval);
+  editor.insert(0, message);
+  printf("ready %zu characters\n", editor.getPlaintext().length());
+  fflush(stdout);
+
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::stringstream stream(line);
+    std::string command;
+    stream >> command;
+    size_t position = 0;
+    stream >> position;
+
+    auto start = std::chrono::steady_clock::now();
+    if (command == "i" || command == "r") {
+      std::string text;
+      stream.get();
+      std::getline(stream, text);
+      if (command == "i") {
+        editor.insert(position, text);
+      } else if (editor.replace(position, text)) {
+        fprintf(stderr, "Replacement runs past the end of the message\n");
+        continue;
+      }
+    } else if (command == "d") {
+      size_t count = 0;
+      stream >> count;
+      editor.erase(position, count);
+    } else if (command == "k") {
+      if (key.setKey(line.substr(line.find('k') + 1))) {
+        continue;
+      }
+      editor.setMachine(key);
+    } else if (command == "p") {
+      size_t count = std::string::npos;
+      stream >> count;
+      const std::string &ciphertext = editor.getCiphertext();
+      position = std::min(position, ciphertext.length());
+      printf("%s\n", ciphertext.substr(position, count).c_str());
+      fflush(stdout);
+      continue;
+    } else if (command == "q") {
+      break;
+    } else {
+      fprintf(stderr, "Commands: i POS TEXT, r POS TEXT, d POS COUNT, "
+                      "k KEY, p [POS] [COUNT], q\n");
+      continue;
+    }
+
+    double microseconds = std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+    printf("ok length=%zu encrypted=%zu walked=%zu %.1fus\n",
+           editor.getPlaintext().length(), editor.getLastEncryptedCount(),
+           editor.getLastWalkedCount(), microseconds);
+    fflush(stdout);
+  }
+  return 0;
+}
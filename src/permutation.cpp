@@ -0,0 +1,202 @@
+#include "../include/Permutation.hpp"
+#include <algorithm>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#endif
+
+namespace {
+
+const unsigned int SIZE = Permutation::SIZE;
+const unsigned int LANES = Permutation::LANES;
+
+unsigned int normalise(int offset) {
+  return ((offset % (int)SIZE) + SIZE) % SIZE;
+}
+
+void composeScalar(const uint8_t *first, const uint8_t *next,
+                   uint8_t *result) {
+  for (unsigned int i = 0; i < LANES; ++i) {
+    result[i] = next[first[i]];
+  }
+}
+
+void conjugateScalar(const uint8_t *images, unsigned int shift,
+                     uint8_t *result) {
+  for (unsigned int i = 0; i < SIZE; ++i) {
+    result[i] = (images[(i + shift) % SIZE] + SIZE - shift) % SIZE;
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3"))) inline __m128i
+lookupShuffle(__m128i low, __m128i upper, __m128i index) {
+  __m128i isUpper = _mm_cmpgt_epi8(index, _mm_set1_epi8(15));
+  __m128i fromLow = _mm_shuffle_epi8(low, index);
+  __m128i fromUpper =
+      _mm_shuffle_epi8(upper, _mm_sub_epi8(index, _mm_set1_epi8(16)));
+  return _mm_or_si128(_mm_andnot_si128(isUpper, fromLow),
+                      _mm_and_si128(isUpper, fromUpper));
+}
+
+__attribute__((target("ssse3"))) inline __m128i wrapLetters(__m128i lanes) {
+  __m128i isWrapped = _mm_cmpgt_epi8(lanes, _mm_set1_epi8(SIZE - 1));
+  return _mm_sub_epi8(lanes, _mm_and_si128(isWrapped, _mm_set1_epi8(SIZE)));
+}
+
+__attribute__((target("ssse3"))) void
+composeShuffle(const uint8_t *first, const uint8_t *next, uint8_t *result) {
+  __m128i low = _mm_load_si128((const __m128i *)next);
+  __m128i upper = _mm_load_si128((const __m128i *)(next + 16));
+  for (unsigned int half = 0; half < LANES; half += 16) {
+    __m128i index = _mm_load_si128((const __m128i *)(first + half));
+    _mm_store_si128((__m128i *)(result + half),
+                    lookupShuffle(low, upper, index));
+  }
+}
+
+__attribute__((target("ssse3"))) void
+conjugateShuffle(const uint8_t *images, unsigned int shift, uint8_t *result) {
+  __m128i low = _mm_load_si128((const __m128i *)images);
+  __m128i upper = _mm_load_si128((const __m128i *)(images + 16));
+  for (unsigned int half = 0; half < LANES; half += 16) {
+    __m128i identity = _mm_add_epi8(
+        _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm_set1_epi8(half));
+    __m128i isLetter = _mm_cmpgt_epi8(_mm_set1_epi8(SIZE), identity);
+    __m128i index = wrapLetters(_mm_add_epi8(identity, _mm_set1_epi8(shift)));
+    __m128i image = wrapLetters(_mm_add_epi8(
+        lookupShuffle(low, upper, _mm_and_si128(isLetter, index)),
+        _mm_set1_epi8(SIZE - shift)));
+    _mm_store_si128((__m128i *)(result + half),
+                    _mm_or_si128(_mm_and_si128(isLetter, image),
+                                 _mm_andnot_si128(isLetter, identity)));
+  }
+}
+#endif
+
+auto selectCompose() {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("ssse3")) {
+    return composeShuffle;
+  }
+#endif
+  return composeScalar;
+}
+
+auto selectConjugate() {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("ssse3")) {
+    return conjugateShuffle;
+  }
+#endif
+  return conjugateScalar;
+}
+
+const auto compose = selectCompose();
+const auto conjugate = selectConjugate();
+
+} // namespace
+
+Permutation::Permutation() {
+  for (unsigned int i = 0; i < LANES; ++i) {
+    images_[i] = i;
+  }
+}
+
+Permutation Permutation::fromSymbols(const char *symbols) {
+  Permutation permutation;
+  for (unsigned int i = 0; i < SIZE; ++i) {
+    permutation.images_[i] = (symbols[i] - 'A') % SIZE;
+  }
+  return permutation;
+}
+
+Permutation Permutation::shift(int offset) {
+  Permutation permutation;
+  unsigned int shift = normalise(offset);
+  for (unsigned int i = 0; i < SIZE; ++i) {
+    permutation.images_[i] = (i + shift) % SIZE;
+  }
+  return permutation;
+}
+
+Permutation Permutation::transposition(unsigned int a, unsigned int b) {
+  Permutation permutation;
+  if (a < SIZE && b < SIZE) {
+    permutation.images_[a] = b;
+    permutation.images_[b] = a;
+  }
+  return permutation;
+}
+
+bool Permutation::operator==(const Permutation &other) const {
+  return memcmp(images_.data(), other.images_.data(), SIZE) == 0;
+}
+
+Permutation Permutation::then(const Permutation &next) const {
+  Permutation result;
+  compose(images_.data(), next.images_.data(), result.images_.data());
+  return result;
+}
+
+Permutation Permutation::inverse() const {
+  Permutation result;
+  for (unsigned int i = 0; i < SIZE; ++i) {
+    result.images_[images_[i]] = i;
+  }
+  return result;
+}
+
+Permutation Permutation::conjugateByShift(int offset) const {
+  Permutation result;
+  conjugate(images_.data(), normalise(offset), result.images_.data());
+  return result;
+}
+
+bool Permutation::isInvolution() const { return then(*this) == Permutation(); }
+
+unsigned int Permutation::getFixedPointCount() const {
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < SIZE; ++i) {
+    count += images_[i] == i;
+  }
+  return count;
+}
+
+void Permutation::getCycleLengths(std::vector<unsigned int> &lengths) const {
+  lengths.clear();
+  uint32_t visited = 0;
+  for (unsigned int start = 0; start < SIZE; ++start) {
+    if (visited & (1u << start)) {
+      continue;
+    }
+    unsigned int length = 0;
+    unsigned int letter = start;
+    while (!(visited & (1u << letter))) {
+      visited |= 1u << letter;
+      letter = images_[letter];
+      length++;
+    }
+    lengths.push_back(length);
+  }
+}
+
+std::string Permutation::describeCycles() const {
+  std::string description;
+  uint32_t visited = 0;
+  for (unsigned int start = 0; start < SIZE; ++start) {
+    if (visited & (1u << start)) {
+      continue;
+    }
+    description += '(';
+    unsigned int letter = start;
+    while (!(visited & (1u << letter))) {
+      visited |= 1u << letter;
+      description += (char)('A' + letter);
+      letter = images_[letter];
+    }
+    description += ')';
+  }
+  return description;
+}
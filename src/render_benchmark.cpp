@@ -0,0 +1,158 @@
+#include "../include/RenderBenchmark.hpp"
+#include "../include/Canvas.hpp"
+#include "../include/Display.hpp"
+#include "../include/Engine.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Panel {
+  Panel(const char *panelName, unsigned int height, unsigned int width)
+      : name(panelName), canvas(height, width), previous(height, width) {}
+
+  const char *name;
+  MemoryCanvas canvas;
+  MemoryCanvas previous;
+  std::vector<uint64_t> nanoseconds;
+  uint64_t changedCells = 0;
+  uint64_t maxChangedCells = 0;
+};
+
+uint64_t getPercentile(std::vector<uint64_t> &values, double percentile) {
+  if (values.empty()) {
+    return 0;
+  }
+  size_t index = std::min(values.size() - 1,
+                          (size_t)(percentile / 100.0 * values.size()));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+uint64_t getMean(const std::vector<uint64_t> &values) {
+  uint64_t total = 0;
+  for (const uint64_t value : values) {
+    total += value;
+  }
+  return values.empty() ? 0 : total / values.size();
+}
+
+uint64_t timeNanoseconds(const std::function<void()> &step) {
+  auto start = std::chrono::steady_clock::now();
+  step();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void printStep(const char *name, std::vector<uint64_t> &nanoseconds) {
+  printf("%-12s %10llu %10llu %10llu %14s %10s\n", name,
+         (unsigned long long)getMean(nanoseconds),
+         (unsigned long long)getPercentile(nanoseconds, 50),
+         (unsigned long long)getPercentile(nanoseconds, 99), "-", "-");
+}
+
+} // namespace
+
+int runRenderBenchmark(unsigned int keys, unsigned int rows,
+                       unsigned int columns) {
+  const unsigned int MAX_ROWS = 4;
+  if (keys == 0 || rows < MAX_ROWS || columns < 3) {
+    fprintf(stderr, "Need at least one key and a %ux3 terminal\n", MAX_ROWS);
+    return 1;
+  }
+
+  unsigned int panelHeight = rows / MAX_ROWS;
+  unsigned int outputWidth = (columns * 2) / 3;
+
+  std::array<Panel, 5> panels = {
+      Panel("rotors", panelHeight, columns),
+      Panel("output", panelHeight, outputWidth),
+      Panel("statistics", panelHeight, columns - outputWidth),
+      Panel("keyboard", panelHeight, columns),
+      Panel("plugboard", panelHeight, columns)};
+  Panel &rotors = panels[0];
+  Panel &output = panels[1];
+  Panel &statistics = panels[2];
+  Panel &keyboard = panels[3];
+  Panel &plugBoard = panels[4];
+  MemoryCanvas screen(rows, columns);
+  SubwindowCanvases canvases = {&rotors.canvas, &output.canvas,
+                                &statistics.canvas, &keyboard.canvas,
+                                &plugBoard.canvas};
+  std::vector<uint64_t> boxNanoseconds, refreshNanoseconds;
+
+  Engine engine(setupEnigmaMachine());
+  engine.setOutputCapacity(getOutputCapacity(output.canvas));
+
+  std::mt19937 generator(1);
+  std::uniform_int_distribution<int> letter(0, 29);
+  std::vector<uint64_t> frameCells;
+  frameCells.reserve(keys);
+
+  for (unsigned int i = 0; i < keys; ++i) {
+    int choice = letter(generator);
+    char key = choice < 26 ? 'A' + choice
+                           : (choice < 29 ? ' ' : Engine::BACKSPACE);
+    engine.submit(key);
+    engine.flush();
+    engine.updateSnapshot();
+    const EngineSnapshot &snapshot = engine.getSnapshot();
+
+    auto measure = [](Panel &panel, const std::function<void()> &draw) {
+      panel.nanoseconds.push_back(timeNanoseconds(draw));
+    };
+
+    measure(keyboard, [&] { drawKeyboard(keyboard.canvas, key); });
+    measure(rotors, [&] { drawRotors(rotors.canvas, snapshot.machine); });
+    measure(plugBoard,
+            [&] { drawPlugBoard(plugBoard.canvas, snapshot.machine); });
+    measure(output, [&] { drawOutput(output.canvas, snapshot.outputText); });
+    measure(statistics, [&] {
+      drawStatistics(statistics.canvas, snapshot.statistics,
+                     snapshot.keyCache);
+    });
+    boxNanoseconds.push_back(
+        timeNanoseconds([&] { drawSubwindowBoxes(canvases); }));
+    refreshNanoseconds.push_back(
+        timeNanoseconds([&] { refreshWindows(screen, canvases); }));
+
+    uint64_t changed = 0;
+    for (auto &panel : panels) {
+      uint64_t panelChanged = panel.canvas.countChangedCells(panel.previous);
+      panel.changedCells += panelChanged;
+      panel.maxChangedCells = std::max(panel.maxChangedCells, panelChanged);
+      panel.previous = panel.canvas;
+      changed += panelChanged;
+    }
+    frameCells.push_back(changed);
+  }
+
+  printf("keys=%u terminal=%ux%u\n", keys, rows, columns);
+  printf("%-12s %10s %10s %10s %14s %10s\n", "panel", "mean ns", "p50 ns",
+         "p99 ns", "cells/key", "max cells");
+  for (auto &panel : panels) {
+    printf("%-12s %10llu %10llu %10llu %14.1f %10llu\n", panel.name,
+           (unsigned long long)getMean(panel.nanoseconds),
+           (unsigned long long)getPercentile(panel.nanoseconds, 50),
+           (unsigned long long)getPercentile(panel.nanoseconds, 99),
+           (double)panel.changedCells / keys,
+           (unsigned long long)panel.maxChangedCells);
+  }
+  printStep("boxes", boxNanoseconds);
+  printStep("refresh", refreshNanoseconds);
+
+  uint64_t totalCells = 0;
+  for (const uint64_t cells : frameCells) {
+    totalCells += cells;
+  }
+  printf("frame cells/key mean=%.1f p99=%llu\n", (double)totalCells / keys,
+         (unsigned long long)getPercentile(frameCells, 99));
+  return 0;
+}
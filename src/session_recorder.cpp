@@ -0,0 +1,246 @@
+#include "../include/SessionRecorder.hpp"
+#include "../include/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ncurses.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char MAGIC[8] = {'E', 'N', 'I', 'G', 'R', 'E', 'C', '1'};
+const uint64_t FRAME_GAP_MICROSECONDS = 1000000 / 60;
+const unsigned int MAX_KEYS_PER_FRAME = 64;
+
+struct RecordedKey {
+  uint64_t microseconds = 0;
+  int key = 0;
+};
+
+struct Session {
+  FILE *recording = nullptr;
+  LatencyHistogram::Clock::time_point lastKeyTime;
+
+  bool replaying = false;
+  bool realTime = false;
+  FILE *terminalOutput = nullptr;
+  SCREEN *terminal = nullptr;
+  unsigned int rows = 24, columns = 80;
+  std::vector<RecordedKey> keys;
+  size_t nextKey = 0;
+  unsigned int keysThisFrame = 0;
+  bool finished = false;
+  LatencyHistogram::Clock::time_point replayStart;
+
+  bool keyPending = false;
+  LatencyHistogram::Clock::time_point firstPendingKey;
+  LatencyHistogram frameLatency;
+};
+
+Session session;
+
+void writeVarint(FILE *file, uint64_t value) {
+  while (value >= 0x80) {
+    fputc((int)(value & 0x7F) | 0x80, file);
+    value >>= 7;
+  }
+  fputc((int)value, file);
+}
+
+bool readVarint(FILE *file, uint64_t &value) {
+  value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    int byte = fgetc(file);
+    if (byte == EOF) {
+      return false;
+    }
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void noteKey() {
+  if (!session.keyPending) {
+    session.keyPending = true;
+    session.firstPendingKey = LatencyHistogram::Clock::now();
+  }
+}
+
+bool isFrameBoundary(const RecordedKey &recorded) {
+  if (session.keysThisFrame == 0) {
+    return false;
+  }
+  const RecordedKey &previous = session.keys[session.nextKey - 1];
+  return session.keysThisFrame >= MAX_KEYS_PER_FRAME ||
+         recorded.microseconds - previous.microseconds >=
+             FRAME_GAP_MICROSECONDS;
+}
+
+} // namespace
+
+int startRecording(const std::string &path) {
+  session.recording = fopen(path.c_str(), "wb");
+  if (!session.recording) {
+    perror(path.c_str());
+    return 1;
+  }
+  fwrite(MAGIC, 1, sizeof(MAGIC), session.recording);
+  writeVarint(session.recording, LINES);
+  writeVarint(session.recording, COLS);
+  session.lastKeyTime = LatencyHistogram::Clock::now();
+  return 0;
+}
+
+int startReplay(const std::string &path, bool realTime) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  char magic[sizeof(MAGIC)] = {};
+  uint64_t rows = 0, columns = 0;
+  if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+      !std::equal(magic, magic + sizeof(magic), MAGIC) ||
+      !readVarint(file, rows) || !readVarint(file, columns)) {
+    fprintf(stderr, "%s is not a session recording\n", path.c_str());
+    fclose(file);
+    return 1;
+  }
+
+  uint64_t microseconds = 0;
+  uint64_t delta = 0, key = 0;
+  while (readVarint(file, delta) && readVarint(file, key)) {
+    microseconds += delta;
+    session.keys.push_back({microseconds, (int)key});
+  }
+  fclose(file);
+
+  session.replaying = true;
+  session.realTime = realTime;
+  session.rows = rows;
+  session.columns = columns;
+  return 0;
+}
+
+bool isReplaying() { return session.replaying; }
+
+bool isReplayFinished() { return session.finished; }
+
+bool isFullSpeedReplay() { return session.replaying && !session.realTime; }
+
+int setupReplayTerminal() {
+  session.terminalOutput = fopen("/dev/null", "w");
+  if (!session.terminalOutput) {
+    perror("/dev/null");
+    return 1;
+  }
+  const char *terminal = getenv("TERM");
+  session.terminal = newterm(terminal ? terminal : "xterm-256color",
+                             session.terminalOutput, stdin);
+  if (!session.terminal) {
+    session.terminal =
+        newterm("xterm-256color", session.terminalOutput, stdin);
+  }
+  if (!session.terminal) {
+    fprintf(stderr, "Could not create a terminal for replay\n");
+    fclose(session.terminalOutput);
+    session.terminalOutput = nullptr;
+    return 1;
+  }
+  set_term(session.terminal);
+  resize_term(session.rows, session.columns);
+  session.replayStart = LatencyHistogram::Clock::now();
+  return 0;
+}
+
+int readKey() {
+  if (!session.replaying) {
+    int key = getch();
+    if (key == ERR) {
+      return key;
+    }
+    noteKey();
+
+    if (session.recording) {
+      auto now = LatencyHistogram::Clock::now();
+      writeVarint(session.recording,
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      now - session.lastKeyTime)
+                      .count());
+      writeVarint(session.recording, key);
+      session.lastKeyTime = now;
+    }
+    return key;
+  }
+
+  if (session.nextKey == session.keys.size()) {
+    session.finished = true;
+    int delay = wgetdelay(stdscr);
+    if (session.realTime && delay > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+    }
+    return ERR;
+  }
+
+  const RecordedKey &recorded = session.keys[session.nextKey];
+  if (!session.realTime) {
+    if (wgetdelay(stdscr) >= 0 && isFrameBoundary(recorded)) {
+      session.keysThisFrame = 0;
+      return ERR;
+    }
+    session.keysThisFrame++;
+  } else {
+    auto due = session.replayStart +
+               std::chrono::microseconds(recorded.microseconds);
+    auto now = LatencyHistogram::Clock::now();
+    if (due > now) {
+      int delay = wgetdelay(stdscr);
+      if (delay >= 0 && due - now > std::chrono::milliseconds(delay)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        return ERR;
+      }
+      std::this_thread::sleep_until(due);
+    }
+  }
+
+  session.nextKey++;
+  noteKey();
+  return recorded.key;
+}
+
+void markFrame() {
+  if (!session.keyPending) {
+    return;
+  }
+  session.frameLatency.record(LatencyHistogram::Clock::now() -
+                              session.firstPendingKey);
+  session.keyPending = false;
+}
+
+void finishSession() {
+  if (session.recording) {
+    fclose(session.recording);
+    session.recording = nullptr;
+  }
+
+  if (session.replaying) {
+    session.replaying = false;
+    endwin();
+    delscreen(session.terminal);
+    fclose(session.terminalOutput);
+    session.terminal = nullptr;
+    session.terminalOutput = nullptr;
+    double seconds = std::chrono::duration<double>(
+                         LatencyHistogram::Clock::now() - session.replayStart)
+                         .count();
+    printf("keys=%zu frames=%llu seconds=%.3f\n", session.nextKey,
+           (unsigned long long)session.frameLatency.getCount(), seconds);
+    printf("frame latency: %s\n", session.frameLatency.summary().c_str());
+  }
+}
@@ -0,0 +1,208 @@
+#include "../include/TextFormat.hpp"
+#include "../include/EnigmaMachine.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const unsigned int BLOCK = 16;
+const unsigned int WIDE_COPY = 8;
+
+typedef uint8_t Block __attribute__((vector_size(BLOCK)));
+typedef int8_t Mask __attribute__((vector_size(BLOCK)));
+
+const char DIGIT_WORDS[10][TextFormat::MAX_EXPANSION + 1] = {
+    "NULL", "EINS", "ZWO", "DREI", "VIER",
+    "FUNF", "SEQS", "SIEBEN", "ACHT", "NEUN"};
+const uint8_t DIGIT_LENGTHS[10] = {4, 4, 3, 4, 4, 4, 4, 6, 4, 4};
+
+Block loadBlock(const char *text) {
+  Block block;
+  memcpy(&block, text, sizeof(block));
+  return block;
+}
+
+bool isAllSet(Mask mask) {
+  uint64_t halves[2];
+  memcpy(halves, &mask, sizeof(halves));
+  return (halves[0] & halves[1]) == ~0ull;
+}
+
+size_t normaliseSymbol(char symbol, char *output, TextFormat::Policy policy) {
+  unsigned int letter = (unsigned char)(symbol | 0x20) - 'a';
+  if (letter < 26) {
+    *output = 'A' + letter;
+    return 1;
+  }
+
+  if (policy == TextFormat::PASS_THROUGH) {
+    *output = symbol;
+    return 1;
+  } else if (policy == TextFormat::HISTORICAL) {
+    unsigned int digit = (unsigned char)symbol - '0';
+    if (digit < 10) {
+      memcpy(output, DIGIT_WORDS[digit], TextFormat::MAX_EXPANSION);
+      return DIGIT_LENGTHS[digit];
+    } else if (symbol == '.' || symbol == ',' || symbol == ':' ||
+               symbol == ';' || symbol == '?' || symbol == '!') {
+      *output = 'X';
+      return 1;
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+size_t TextFormat::normalise(const char *input, size_t length, char *output,
+                             Policy policy) {
+  char *start = output;
+  size_t i = 0;
+  for (; i + BLOCK <= length; i += BLOCK) {
+    Block block = loadBlock(input + i);
+    Mask isLetter = (Mask)((Block)((block | 0x20) - 'a') < 26);
+    Block upper = block & (Block)~((Block)isLetter & 0x20);
+
+    if (policy == PASS_THROUGH || isAllSet(isLetter)) {
+      memcpy(output, &upper, sizeof(upper));
+      output += BLOCK;
+    } else if (policy == FILTER) {
+      for (unsigned int j = 0; j < BLOCK; ++j) {
+        *output = upper[j];
+        output -= isLetter[j];
+      }
+    } else {
+      for (unsigned int j = 0; j < BLOCK; ++j) {
+        output += normaliseSymbol(input[i + j], output, policy);
+      }
+    }
+  }
+  for (; i < length; ++i) {
+    output += normaliseSymbol(input[i], output, policy);
+  }
+  return output - start;
+}
+
+TextFormat::TextFormat(unsigned int groupLength, unsigned int groupsPerLine)
+    : groupLength_(groupLength > 0 ? groupLength : GROUP_LENGTH),
+      lineLength_(groupLength_ * (groupsPerLine > 0 ? groupsPerLine : 1)) {}
+
+size_t TextFormat::getMaxGroupedLength(size_t length) const {
+  return length + length / groupLength_ + WIDE_COPY + 1;
+}
+
+size_t TextFormat::group(const char *letters, size_t length, char *output) {
+  char *start = output;
+  size_t i = 0;
+  while (i < length) {
+    while (groupColumn_ == groupLength_ && column_ < lineLength_ &&
+           groupLength_ <= WIDE_COPY && i + WIDE_COPY <= length) {
+      *output = ' ';
+      memcpy(output + 1, letters + i, WIDE_COPY);
+      output += groupLength_ + 1;
+      column_ += groupLength_;
+      i += groupLength_;
+    }
+
+    if (i == length) {
+      break;
+    } else if (groupColumn_ == groupLength_) {
+      groupColumn_ = 0;
+      if (column_ == lineLength_) {
+        column_ = 0;
+        *output++ = '\n';
+      } else {
+        *output++ = ' ';
+      }
+    }
+
+    size_t count = groupLength_ - groupColumn_;
+    if (count <= WIDE_COPY && i + WIDE_COPY <= length) {
+      memcpy(output, letters + i, WIDE_COPY);
+    } else {
+      if (count > length - i) {
+        count = length - i;
+      }
+      memcpy(output, letters + i, count);
+    }
+    output += count;
+    groupColumn_ += count;
+    column_ += count;
+    i += count;
+  }
+  return output - start;
+}
+
+size_t TextFormat::finish(char *output) {
+  if (column_ == 0) {
+    return 0;
+  }
+  column_ = 0;
+  groupColumn_ = 0;
+  *output = '\n';
+  return 1;
+}
+
+int encryptFile(const std::string &path, TextFormat::Policy policy,
+                bool grouped) {
+  FILE *file = path == "-" ? stdin : fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  const size_t CHUNK_SIZE = 1 << 20;
+  EnigmaMachine machine = setupEnigmaMachine();
+  TextFormat format;
+  std::vector<char> input(CHUNK_SIZE);
+  std::vector<char> letters(CHUNK_SIZE * TextFormat::MAX_EXPANSION);
+  std::vector<char> output(format.getMaxGroupedLength(letters.size()));
+  grouped &= policy != TextFormat::PASS_THROUGH;
+
+  using Clock = std::chrono::steady_clock;
+  Clock::duration normaliseTime = {}, encryptTime = {}, groupTime = {};
+  size_t inputBytes = 0, letterCount = 0;
+  size_t length = 0;
+  while ((length = fread(input.data(), 1, input.size(), file)) > 0) {
+    auto start = Clock::now();
+    size_t letterLength =
+        TextFormat::normalise(input.data(), length, letters.data(), policy);
+    auto normalised = Clock::now();
+    machine.encryptText(letters.data(), letterLength);
+    auto encrypted = Clock::now();
+
+    const char *result = letters.data();
+    size_t resultLength = letterLength;
+    if (grouped) {
+      resultLength = format.group(letters.data(), letterLength, output.data());
+      result = output.data();
+    }
+    groupTime += Clock::now() - encrypted;
+    encryptTime += encrypted - normalised;
+    normaliseTime += normalised - start;
+    inputBytes += length;
+    letterCount += letterLength;
+
+    fwrite(result, 1, resultLength, stdout);
+  }
+  if (grouped) {
+    fwrite(output.data(), 1, format.finish(output.data()), stdout);
+  }
+  if (file != stdin) {
+    fclose(file);
+  }
+
+  auto rate = [](size_t bytes, Clock::duration time) {
+    double seconds = std::chrono::duration<double>(time).count();
+    return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0;
+  };
+  fprintf(stderr,
+          "bytes=%zu letters=%zu normalise=%.2f GB/s encrypt=%.3f GB/s "
+          "group=%.2f GB/s\n",
+          inputBytes, letterCount, rate(inputBytes, normaliseTime),
+          rate(letterCount, encryptTime), rate(letterCount, groupTime));
+  return 0;
+}
@@ -0,0 +1,208 @@
+#include "../include/TextStatistics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const unsigned int BLOCK = 16;
+const unsigned int RUN_BLOCKS = 255;
+const unsigned int LETTER_GROUP = 13;
+
+typedef uint8_t Block __attribute__((vector_size(BLOCK)));
+
+void countLetters(const Block *indexes, size_t blocks, unsigned int first,
+                  uint64_t *counts) {
+  Block lanes[LETTER_GROUP] = {};
+  for (size_t i = 0; i < blocks; ++i) {
+#pragma GCC unroll 13
+    for (unsigned int letter = 0; letter < LETTER_GROUP; ++letter) {
+      lanes[letter] -= (Block)(indexes[i] == (uint8_t)(first + letter));
+    }
+  }
+  for (unsigned int letter = 0; letter < LETTER_GROUP; ++letter) {
+    for (unsigned int lane = 0; lane < BLOCK; ++lane) {
+      counts[first + letter] += lanes[letter][lane];
+    }
+  }
+}
+
+} // namespace
+
+int TextStatistics::getIndex(char letter) {
+  unsigned int index = (unsigned char)(letter | 0x20) - 'a';
+  return index < LETTERS ? (int)index : -1;
+}
+
+void TextStatistics::add(char previous, char letter) {
+  int index = getIndex(letter);
+  if (index < 0) {
+    return;
+  }
+
+  coincidences_ += 2 * frequencies_[index];
+  frequencies_[index]++;
+  letterCount_++;
+
+  int previousIndex = getIndex(previous);
+  if (previousIndex >= 0) {
+    bigrams_[previousIndex * LETTERS + index]++;
+  }
+}
+
+void TextStatistics::remove(char previous, char letter) {
+  int index = getIndex(letter);
+  if (index < 0 || frequencies_[index] == 0) {
+    return;
+  }
+
+  frequencies_[index]--;
+  coincidences_ -= 2 * frequencies_[index];
+  letterCount_--;
+
+  int previousIndex = getIndex(previous);
+  if (previousIndex >= 0 && bigrams_[previousIndex * LETTERS + index] > 0) {
+    bigrams_[previousIndex * LETTERS + index]--;
+  }
+}
+
+void TextStatistics::addText(const char *text, size_t length,
+                             char &previous) {
+  std::array<Block, RUN_BLOCKS> run;
+  std::array<uint64_t, LETTERS> counts = {};
+  unsigned int previousIndex = (uint8_t)getIndex(previous);
+
+  for (size_t start = 0; start < length; start += RUN_BLOCKS * BLOCK) {
+    size_t runLength = std::min<size_t>(length - start, RUN_BLOCKS * BLOCK);
+    size_t blocks = (runLength + BLOCK - 1) / BLOCK;
+    run[blocks - 1] = ~Block{};
+    memcpy(run.data(), text + start, runLength);
+    for (size_t i = 0; i < blocks; ++i) {
+      run[i] = (run[i] | 0x20) - 'a';
+      run[i] |= (Block)(run[i] >= LETTERS);
+    }
+
+    for (unsigned int first = 0; first < LETTERS; first += LETTER_GROUP) {
+      countLetters(run.data(), blocks, first, counts.data());
+    }
+
+    const uint8_t *indexes = (const uint8_t *)run.data();
+    for (size_t i = 0; i < runLength; ++i) {
+      if (previousIndex < LETTERS && indexes[i] < LETTERS) {
+        bigrams_[previousIndex * LETTERS + indexes[i]]++;
+      }
+      previousIndex = indexes[i];
+    }
+  }
+
+  for (unsigned int letter = 0; letter < LETTERS; ++letter) {
+    uint64_t count = counts[letter];
+    coincidences_ += count * (count + 2 * frequencies_[letter] - 1);
+    frequencies_[letter] += count;
+    letterCount_ += count;
+  }
+
+  if (length > 0) {
+    previous = text[length - 1];
+  }
+}
+
+void TextStatistics::merge(const TextStatistics &other) {
+  for (unsigned int letter = 0; letter < LETTERS; ++letter) {
+    coincidences_ += 2 * frequencies_[letter] * other.frequencies_[letter];
+    frequencies_[letter] += other.frequencies_[letter];
+  }
+  for (size_t i = 0; i < bigrams_.size(); ++i) {
+    bigrams_[i] += other.bigrams_[i];
+  }
+  coincidences_ += other.coincidences_;
+  letterCount_ += other.letterCount_;
+}
+
+void TextStatistics::clear() { *this = TextStatistics(); }
+
+uint64_t TextStatistics::getLetterCount() const { return letterCount_; }
+
+uint64_t TextStatistics::getFrequency(char letter) const {
+  int index = getIndex(letter);
+  return index < 0 ? 0 : frequencies_[index];
+}
+
+uint64_t TextStatistics::getBigramCount(char first, char second) const {
+  int firstIndex = getIndex(first);
+  int secondIndex = getIndex(second);
+  if (firstIndex < 0 || secondIndex < 0) {
+    return 0;
+  }
+  return bigrams_[firstIndex * LETTERS + secondIndex];
+}
+
+double TextStatistics::getIndexOfCoincidence() const {
+  if (letterCount_ < 2) {
+    return 0.0;
+  }
+  return (double)coincidences_ /
+         ((double)letterCount_ * (double)(letterCount_ - 1));
+}
+
+std::vector<std::pair<std::string, uint64_t>>
+TextStatistics::getTopBigrams(unsigned int limit) const {
+  std::vector<std::pair<std::string, uint64_t>> top;
+  for (unsigned int i = 0; i < bigrams_.size(); ++i) {
+    if (bigrams_[i] == 0) {
+      continue;
+    }
+    std::string bigram = {(char)('A' + i / LETTERS), (char)('A' + i % LETTERS)};
+    top.emplace_back(bigram, bigrams_[i]);
+  }
+
+  std::sort(top.begin(), top.end(), [](const auto &a, const auto &b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+  if (top.size() > limit) {
+    top.resize(limit);
+  }
+  return top;
+}
+
+int printTextStatistics(const std::string &path) {
+  FILE *file = path == "-" ? stdin : fopen(path.c_str(), "rb");
+  if (!file) {
+    perror(path.c_str());
+    return 1;
+  }
+
+  const size_t CHUNK_SIZE = 1 << 20;
+  std::vector<char> chunk(CHUNK_SIZE);
+  TextStatistics statistics;
+  char previous = '\0';
+  uint64_t bytes = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  size_t length = 0;
+  while ((length = fread(chunk.data(), 1, chunk.size(), file)) > 0) {
+    statistics.addText(chunk.data(), length, previous);
+    bytes += length;
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (file != stdin) {
+    fclose(file);
+  }
+
+  printf("bytes=%llu letters=%llu ic=%.5f (%.2f MB/s)\n",
+         (unsigned long long)bytes,
+         (unsigned long long)statistics.getLetterCount(),
+         statistics.getIndexOfCoincidence(),
+         seconds > 0.0 ? bytes / seconds / 1e6 : 0.0);
+  for (char letter = 'A'; letter <= 'Z'; ++letter) {
+    printf("%c %llu\n", letter,
+           (unsigned long long)statistics.getFrequency(letter));
+  }
+  for (const auto &[bigram, count] : statistics.getTopBigrams(10)) {
+    printf("%s %llu\n", bigram.c_str(), (unsigned long long)count);
+  }
+  return 0;
+}
@@ -0,0 +1,228 @@
+#include "../include/TrafficGenerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+
+const unsigned int LETTERS = 26;
+const size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+const char *const WORDS[] = {
+    "THE",     "OF",      "AND",    "TO",      "IN",     "A",       "IS",
+    "THAT",    "FOR",     "IT",     "AS",      "WAS",    "WITH",    "BE",
+    "BY",      "ON",      "NOT",    "HE",      "THIS",   "ARE",     "OR",
+    "HIS",     "FROM",    "AT",     "WHICH",   "BUT",    "HAVE",    "AN",
+    "HAD",     "THEY",    "YOU",    "WERE",    "THEIR",  "ONE",     "ALL",
+    "WE",      "CAN",     "HER",    "HAS",     "THERE",  "BEEN",    "IF",
+    "MORE",    "WHEN",    "WILL",   "WOULD",   "WHO",    "SO",      "NO",
+    "ENEMY",   "ATTACK",  "NORTH",  "SOUTH",   "EAST",   "WEST",    "REPORT",
+    "POSITION", "UNITS",  "ARMY",   "DIVISION", "FORCES", "MOVE",   "HOLD",
+    "WEATHER", "CLEAR",   "RAIN",   "WIND",    "SHIPS",  "CONVOY",  "HARBOUR",
+    "SUPPLY",  "FUEL",    "AMMUNITION", "ORDERS", "COMMAND", "GENERAL",
+    "OFFICER", "COMPANY", "BRIDGE", "RIVER",   "ROAD",   "TOWN",    "NIGHT",
+    "MORNING", "TODAY",   "TOMORROW", "ARRIVED", "EXPECTED", "REQUEST",
+    "IMMEDIATELY", "STOP", "NUMBER", "HOURS",  "MILES",  "SECTOR",  "LINE",
+    "FRONT",   "RETREAT", "ADVANCE", "DEFENCE", "STRENGTH", "LOSSES"};
+const unsigned int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+uint64_t nextRandom(uint64_t &state) {
+  uint64_t value = (state += 0x9E3779B97F4A7C15ull);
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+unsigned int nextBelow(uint64_t &state, unsigned int bound) {
+  return (unsigned int)(((nextRandom(state) >> 32) * bound) >> 32);
+}
+
+bool writeAll(FILE *file, const std::string &buffer) {
+  return fwrite(buffer.data(), 1, buffer.length(), file) == buffer.length();
+}
+
+} // namespace
+
+void TrafficKey::apply(EnigmaMachine &machine) const {
+  machine.setRotorOrder(order);
+  machine.setRotorPositions(positions);
+  for (unsigned int i = 0; i < plugs.size(); ++i) {
+    machine.setCable(i, plugs[i].first, plugs[i].second);
+  }
+}
+
+std::string TrafficKey::describe(EnigmaMachine machine) const {
+  apply(machine);
+  return machine.describeKey();
+}
+
+TrafficGenerator::TrafficGenerator(const Options &options)
+    : options_(options) {
+  options_.shards = std::max(1u, options_.shards);
+  uint32_t total = 0;
+  for (unsigned int rank = 1; rank <= WORD_COUNT; ++rank) {
+    total += 100000 / (rank + 2);
+    cumulativeWeights_.push_back(total);
+  }
+}
+
+TrafficKey TrafficGenerator::generateKey(uint64_t &state) const {
+  TrafficKey key;
+  std::vector<unsigned int> rotors(machine_.getAvaliableRotors().size());
+  for (unsigned int i = 0; i < rotors.size(); ++i) {
+    rotors[i] = i;
+  }
+  for (unsigned int i = 0; i < key.order.size() && i < rotors.size(); ++i) {
+    std::swap(rotors[i], rotors[i + nextBelow(state, rotors.size() - i)]);
+    key.order[i] = rotors[i];
+  }
+  for (auto &position : key.positions) {
+    position = nextBelow(state, LETTERS);
+  }
+
+  std::array<char, LETTERS> letters;
+  for (unsigned int i = 0; i < LETTERS; ++i) {
+    letters[i] = 'A' + i;
+  }
+  unsigned int cables = nextBelow(state, EnigmaMachine::MAX_CABLES_ + 1);
+  for (unsigned int i = 0; i < cables * 2; ++i) {
+    std::swap(letters[i], letters[i + nextBelow(state, LETTERS - i)]);
+  }
+  for (unsigned int i = 0; i < cables; ++i) {
+    key.plugs.emplace_back(letters[i * 2], letters[i * 2 + 1]);
+  }
+  return key;
+}
+
+void TrafficGenerator::generatePlaintext(uint64_t &state,
+                                         std::string &plaintext) const {
+  plaintext.clear();
+  while (plaintext.length() < options_.length) {
+    uint32_t pick = nextBelow(state, cumulativeWeights_.back());
+    auto word = std::upper_bound(cumulativeWeights_.begin(),
+                                 cumulativeWeights_.end(), pick);
+    plaintext += WORDS[word - cumulativeWeights_.begin()];
+  }
+  plaintext.resize(options_.length);
+}
+
+void TrafficGenerator::generateMessage(uint64_t index, TrafficKey &key,
+                                       std::string &plaintext,
+                                       std::string &ciphertext) const {
+  uint64_t state = options_.seed;
+  state = nextRandom(state) ^ index;
+  nextRandom(state);
+
+  key = generateKey(state);
+  generatePlaintext(state, plaintext);
+
+  EnigmaMachine machine = machine_;
+  key.apply(machine);
+  ciphertext = plaintext;
+  machine.encryptText(ciphertext);
+}
+
+int TrafficGenerator::writeShard(const std::string &directory,
+                                 unsigned int shard, uint64_t &bytes) const {
+  char name[32];
+  snprintf(name, sizeof(name), "/traffic-%05u.txt", shard);
+  std::string trafficPath = directory + name;
+  snprintf(name, sizeof(name), "/keys-%05u.tsv", shard);
+  std::string keysPath = directory + name;
+
+  FILE *traffic = fopen(trafficPath.c_str(), "wb");
+  FILE *keys = fopen(keysPath.c_str(), "wb");
+  if (!traffic || !keys) {
+    perror(traffic ? keysPath.c_str() : trafficPath.c_str());
+    if (traffic) {
+      fclose(traffic);
+    }
+    if (keys) {
+      fclose(keys);
+    }
+    return 1;
+  }
+
+  uint64_t first = (uint64_t)options_.messages * shard / options_.shards;
+  uint64_t last = (uint64_t)options_.messages * (shard + 1) / options_.shards;
+
+  TrafficKey key;
+  std::string plaintext, ciphertext, trafficBuffer, keysBuffer;
+  bool written = true;
+  for (uint64_t index = first; index < last && written; ++index) {
+    generateMessage(index, key, plaintext, ciphertext);
+    trafficBuffer += ciphertext;
+    trafficBuffer += '\n';
+    keysBuffer += std::to_string(index) + '\t' + key.describe(machine_) + '\t' +
+                  plaintext + '\n';
+
+    if (trafficBuffer.length() >= WRITE_BUFFER_SIZE || index + 1 == last) {
+      written = writeAll(traffic, trafficBuffer) && writeAll(keys, keysBuffer);
+      bytes += trafficBuffer.length() + keysBuffer.length();
+      trafficBuffer.clear();
+      keysBuffer.clear();
+    }
+  }
+
+  written &= fclose(traffic) == 0;
+  written &= fclose(keys) == 0;
+  if (!written) {
+    perror(trafficPath.c_str());
+    return 1;
+  }
+  return 0;
+}
+
+int generateTraffic(const std::string &directory,
+                    const TrafficGenerator::Options &options) {
+  if (mkdir(directory.c_str(), 0755) == -1 && errno != EEXIST) {
+    perror(directory.c_str());
+    return 1;
+  }
+
+  TrafficGenerator generator(options);
+  unsigned int shards = std::max(1u, options.shards);
+  unsigned int threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, shards);
+
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<unsigned int> nextShard = 0;
+  std::atomic<uint64_t> totalBytes = 0;
+  std::atomic<int> error = 0;
+  auto work = [&] {
+    unsigned int shard = 0;
+    uint64_t bytes = 0;
+    while ((shard = nextShard.fetch_add(1)) < shards && !error) {
+      error |= generator.writeShard(directory, shard, bytes);
+    }
+    totalBytes += bytes;
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  fprintf(stderr,
+          "messages=%u letters=%llu shards=%u threads=%u bytes=%llu "
+          "(%.2fs, %.1f MB/s)\n",
+          options.messages,
+          (unsigned long long)options.messages * options.length, shards,
+          threads, (unsigned long long)totalBytes.load(), seconds,
+          seconds > 0.0 ? totalBytes / seconds / 1e6 : 0.0);
+  return error;
+}